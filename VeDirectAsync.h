@@ -0,0 +1,227 @@
+/* VeDirectAsync.h
+ *
+ * C++20 coroutine awaitables for TEXT frames and HEX queries of one frame handler.
+ * Header only, the library itself does not need C++20.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - terminate on exceptions escaping a VeDirectTask
+ * 2026.10.14 - 0.3 - register a query before sending it
+ * 2026.10.14 - 0.4 - attached(), awaiters of destroyed coroutines unregister themselves
+ * 2026.10.14 - 0.5 - queries fail at once without a clock, they could never time out
+ */
+
+#ifndef VEDIRECTASYNC_H_
+#define VEDIRECTASYNC_H_
+
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <exception>
+
+#include "VeDirectFrameHandler.h"
+
+/**
+ * @brief Fire and forget coroutine, starts at once and frees itself when done
+ * @details Use it as return type of coroutines that co_await VeDirectAsync, or any other task type.
+ *          Nobody waits for the result, so an exception leaving the coroutine calls std::terminate().
+ */
+struct VeDirectTask {
+  struct promise_type {
+    VeDirectTask get_return_object() { return { }; }
+    std::suspend_never initial_suspend() noexcept { return { }; }
+    std::suspend_never final_suspend() noexcept { return { }; }
+    void return_void() { }
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+/**
+ * @brief Awaitables on top of the callbacks of one frame handler
+ * @details rxData stays the synchronous engine: the coroutines waiting for a frame are resumed
+ *          from the frame callback inside rxData, those waiting for a HEX response from the HEX
+ *          callbacks (rxData or pollHex) or from expire() on timeout. So one event loop can run the
+ *          sessions of many devices without threads. The waiting coroutines are linked through
+ *          their awaiters, waiting does not allocate.
+ *          Check attached() after construction: without free frame and HEX callback slots of the
+ *          handler nothing is resumed, queries then fail at once.
+ *          A waiting coroutine may be destroyed, its awaiter unregisters itself. Destroy the
+ *          waiting coroutines before this object, they are not resumed anymore.
+ *
+ * @code
+ * VeDirectTask watchPanel(VeDirectAsync& ve) {
+ *   for (;;) {
+ *     VeDirectFrameHandlerBase& handler = co_await ve.nextFrame();
+ *     VeHexMessage message;
+ *     if (co_await ve.query(0xEDBB, message)) printf("panel %u\n", message.value);
+ *   }
+ * }
+ * @endcode
+ */
+class VeDirectAsync {
+  public:
+    typedef int (*writeFunction)(const char* buffer, int len, void* ctx); // returns < 0 on error
+
+    /**
+     * @param handler   Handler to wait on
+     * @param write     Function that sends a command to the device, needed by query()
+     * @param ctx       Additional data passed to write
+     * @param clock     Time source of the query timeouts, in the unit of the timeout, needed by
+     *                  query(): without it a query could wait forever, so it fails at once
+     */
+    VeDirectAsync(VeDirectFrameHandlerBase& handler, writeFunction write = nullptr, void* ctx = nullptr, veClockFunction clock = nullptr)
+      : mHandler(handler), mWrite(write), mWriteCtx(ctx), mClock(clock) {
+      mFrameHandle = handler.addFrameCallback(frameEvent, this);
+      mHexHandle = handler.addHexMessageCallback(VE_HEX_ANY, VE_HEX_ANY_REGISTER, VeHexRequestTable::messageCallback, &mRequests);
+      if (!attached()) detach();
+    }
+    ~VeDirectAsync() { detach(); }
+    VeDirectAsync(const VeDirectAsync&) = delete;
+    VeDirectAsync& operator=(const VeDirectAsync&) = delete;
+
+    /**
+     * @brief Check if the frame and HEX callbacks were registered, see VeCallbackCapacity
+     */
+    bool attached() const { return mFrameHandle >= 0 && mHexHandle >= 0; }
+
+    /**
+     * @brief co_await the next valid TEXT frame, returns the handler
+     * @details Never resumed if the handler is not attached().
+     */
+    class FrameAwaiter {
+      public:
+        explicit FrameAwaiter(VeDirectAsync& async) : mAsync(async) { }
+        ~FrameAwaiter() {
+          if (!mLinked) return;             // the coroutine is destroyed while waiting
+          unlink(mAsync.mFrameWaiters);
+          unlink(mAsync.mResuming);
+        }
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> waiter) noexcept {
+          mWaiter = waiter;
+          mNext = mAsync.mFrameWaiters;
+          mAsync.mFrameWaiters = this;
+          mLinked = true;
+        }
+        VeDirectFrameHandlerBase& await_resume() const noexcept { return mAsync.mHandler; }
+
+      private:
+        friend class VeDirectAsync;
+        VeDirectAsync& mAsync;
+        std::coroutine_handle<> mWaiter;
+        FrameAwaiter* mNext = nullptr;      // next coroutine waiting for the same frame
+        bool mLinked = false;               // in mFrameWaiters or mResuming
+
+        void unlink(FrameAwaiter*& list) {
+          for (FrameAwaiter** link = &list; *link; link = &(*link)->mNext) {
+            if (*link != this) continue;
+            *link = mNext;
+            return;
+          }
+        }
+    };
+
+    /**
+     * @brief co_await the response to a get command, returns true and the response, or false on error or timeout
+     * @details Fails at once, without sending the command, if there is no write function, no
+     *          clock or the handler is not attached().
+     */
+    class QueryAwaiter {
+      public:
+        QueryAwaiter(VeDirectAsync& async, uint16_t reg, uint32_t timeout, VeHexMessage& message)
+          : mAsync(async), mReg(reg), mTimeout(timeout), mMessage(message) { }
+        ~QueryAwaiter() {
+          if (mPending) mAsync.mRequests.cancel(this);      // the coroutine is destroyed while waiting
+        }
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> waiter) noexcept {
+          char command[16];
+          int len = veHexEncodeGet(command, sizeof(command), mReg);
+          // false resumes at once with false, the response arrives with a later rxData or pollHex
+          if (len <= 0 || !mAsync.mWrite || !mAsync.mClock || !mAsync.attached()) return false;
+          uint32_t now = mAsync.mClock();
+          // registered first, write may already feed the response to rxData
+          if (mAsync.mRequests.add(VE_HEX_CMD_GET, mReg, now, mTimeout, responseEvent, this) < 0) return false;
+          mPending = true;
+          if (mAsync.mWrite(command, len, mAsync.mWriteCtx) < 0) {
+            mAsync.mRequests.cancel(this);
+            mPending = false;
+            return false;
+          }
+          if (!mPending) return false;      // answered inside write
+          mWaiter = waiter;
+          return true;
+        }
+        bool await_resume() const noexcept { return mOk; }
+
+      private:
+        VeDirectAsync& mAsync;
+        uint16_t mReg;
+        uint32_t mTimeout;
+        VeHexMessage& mMessage;
+        std::coroutine_handle<> mWaiter;
+        bool mPending = false;              // registered in mRequests, waiting for the response
+        bool mOk = false;
+
+        static void responseEvent(const VeHexMessage* message, void* awaiter) {
+          QueryAwaiter& self = *static_cast<QueryAwaiter*>(awaiter);
+          self.mPending = false;
+          if (message) self.mMessage = *message;
+          self.mOk = message && message->response == VE_HEX_GET && !(message->flags & (VE_HEX_FLAG_UNKNOWN_ID | VE_HEX_FLAG_NOT_SUPPORTED));
+          if (self.mWaiter) self.mWaiter.resume();
+        }
+    };
+
+    FrameAwaiter nextFrame() { return FrameAwaiter(*this); }
+    QueryAwaiter query(uint16_t reg, VeHexMessage& message, uint32_t timeout = 1000) {
+      return QueryAwaiter(*this, reg, timeout, message);
+    }
+
+    /**
+     * @brief Resume the queries without response within their timeout, call it regularly
+     *
+     * @return int Number of queries that timed out
+     */
+    int expire() { return mRequests.expire(mClock ? mClock() : 0); }
+
+  private:
+    VeDirectFrameHandlerBase& mHandler;
+    writeFunction mWrite;
+    void* mWriteCtx;
+    veClockFunction mClock;
+    int mFrameHandle;
+    int mHexHandle;
+    FrameAwaiter* mFrameWaiters = nullptr;  // coroutines waiting for the next frame
+    FrameAwaiter* mResuming = nullptr;      // coroutines of the current frame not resumed yet
+    VeHexRequestTable mRequests;            // queries in flight
+
+    void detach() {
+      if (mFrameHandle >= 0) mHandler.removeFrameCallback(mFrameHandle);
+      if (mHexHandle >= 0) mHandler.removeHexMessageCallback(mHexHandle);
+      mFrameHandle = -1;
+      mHexHandle = -1;
+    }
+
+    static void frameEvent(VeDirectFrameHandlerBase&, void* async) {
+      VeDirectAsync& self = *static_cast<VeDirectAsync*>(async);
+      // resumed coroutines may wait again, they are then resumed by the next frame. A frame
+      // committed by a resumed coroutine also resumes the rest of the current one.
+      if (self.mFrameWaiters) {
+        FrameAwaiter** tail = &self.mFrameWaiters;
+        while (*tail) tail = &(*tail)->mNext;
+        *tail = self.mResuming;
+        self.mResuming = self.mFrameWaiters;
+        self.mFrameWaiters = nullptr;
+      }
+      while (FrameAwaiter* waiter = self.mResuming) {
+        self.mResuming = waiter->mNext;
+        waiter->mLinked = false;
+        waiter->mWaiter.resume();
+      }
+    }
+};
+
+#endif // __cplusplus >= 202002L
+
+#endif // VEDIRECTASYNC_H_
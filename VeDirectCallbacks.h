@@ -0,0 +1,169 @@
+/* VeDirectCallbacks.h
+ *
+ * Non-owning callable references and a fixed capacity callback registry.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - registry on caller provided slots, handles are always > 0
+ * 2026.10.14 - 0.3 - no <type_traits>, it is missing on AVR
+ */
+
+#ifndef VEDIRECTCALLBACKS_H_
+#define VEDIRECTCALLBACKS_H_
+
+#include <stdint.h>
+
+// the few traits needed by VeCallback, avr-gcc ships no <type_traits>
+template <bool Condition, typename T = void> struct VeEnableIf { };
+template <typename T> struct VeEnableIf<true, T> { typedef T type; };
+template <typename T> struct VeRemoveCv { typedef T type; };
+template <typename T> struct VeRemoveCv<const T> { typedef T type; };
+template <typename T> struct VeRemoveCv<volatile T> { typedef T type; };
+template <typename T> struct VeRemoveCv<const volatile T> { typedef T type; };
+template <typename T, typename U> struct VeIsSame { static constexpr bool value = false; };
+template <typename T> struct VeIsSame<T, T> { static constexpr bool value = true; };
+template <typename T> struct VeIsConst { static constexpr bool value = false; };
+template <typename T> struct VeIsConst<const T> { static constexpr bool value = true; };
+// const is ignored on function types (and references), so only they stay non-const
+template <typename T> struct VeIsFunction { static constexpr bool value = !VeIsConst<const T>::value; };
+
+template <typename Signature>
+class VeCallback;
+
+/**
+ * @brief Reference to something callable with the arguments Args, without allocations
+ * @details Holds a plain function, a function with an additional data pointer as last argument
+ *          (the classic callback style of this library), or a reference to a callable object
+ *          like a lambda with captures. The object is not copied, it must outlive the callback
+ *          (for a lambda: store it in a variable, a temporary can't be passed).
+ */
+template <typename R, typename... Args>
+class VeCallback<R(Args...)> {
+  public:
+    VeCallback() = default;
+    VeCallback(R (*function)(Args...))
+      : mFunction(reinterpret_cast<void (*)()>(function)), mCall(callFunction) { }
+    VeCallback(R (*function)(Args..., void*), void* data)
+      : mFunction(reinterpret_cast<void (*)()>(function)), mData(data), mCall(callFunctionData) { }
+    template <typename F, typename = typename VeEnableIf<!VeIsFunction<F>::value &&
+                                                         !VeIsSame<typename VeRemoveCv<F>::type, VeCallback>::value>::type>
+    VeCallback(F& callable)
+      : mData((void*)&callable), mCall(callCallable<F>) { }
+
+    R operator()(Args... args) const { return mCall(*this, args...); }
+    explicit operator bool() const { return mCall != nullptr; }
+
+  private:
+    void (*mFunction)() = nullptr;              // plain function, cast back to its type by mCall
+    void* mData = nullptr;                      // additional data or the callable object
+    R (*mCall)(const VeCallback&, Args...) = nullptr;
+
+    static R callFunction(const VeCallback& cb, Args... args) {
+      return reinterpret_cast<R (*)(Args...)>(cb.mFunction)(args...);
+    }
+    static R callFunctionData(const VeCallback& cb, Args... args) {
+      return reinterpret_cast<R (*)(Args..., void*)>(cb.mFunction)(args..., cb.mData);
+    }
+    template <typename F>
+    static R callCallable(const VeCallback& cb, Args... args) {
+      return (*static_cast<F*>(cb.mData))(args...);
+    }
+};
+
+template <typename Entry>
+struct VeCallbackSlot {                         // one entry of a VeCallbackRegistry
+  Entry entry;
+  uint16_t generation;                          // incremented on remove, part of the handle
+};
+
+/**
+ * @brief Fixed capacity registry of callback entries with O(1) add and remove
+ * @details The slots are provided by the owner (see VeCallbackList), so code using the registry
+ *          does not depend on its capacity. add() returns a handle, remove() takes it. A handle
+ *          holds the slot and a generation of the slot, so a handle of a removed entry can't
+ *          remove a later entry in the same slot. Handles are always > 0.
+ *          Entries are visited in slot order: the order of add() as long as nothing was
+ *          removed. Removing entries from inside a callback is safe, the removed entries are
+ *          not visited anymore. Entries added inside a callback are visited from the next run.
+ */
+template <typename Entry>
+class VeCallbackRegistry {
+  public:
+    typedef VeCallbackSlot<Entry> Slot;
+
+    /**
+     * @param slots     Zero initialized slots, at least capacity
+     * @param capacity  Number of slots, 0..32
+     */
+    VeCallbackRegistry(Slot* slots, uint8_t capacity) : mSlots(slots), mCapacity(capacity > 32 ? 32 : capacity) { }
+    VeCallbackRegistry(const VeCallbackRegistry&) = delete;
+    VeCallbackRegistry& operator=(const VeCallbackRegistry&) = delete;
+
+    /**
+     * @brief Add an entry
+     *
+     * @param entry   Entry to copy into the registry
+     * @return int    Handle (> 0) for remove() or -1 if the registry is full
+     */
+    int add(const Entry& entry) {
+      uint32_t free = ~mUsed & (mCapacity == 32 ? 0xFFFFFFFFu : (1u << mCapacity) - 1);
+      if (!free) return -1;
+      int slot = __builtin_ctz(free);
+      mSlots[slot].entry = entry;
+      mUsed |= 1u << slot;
+      return ((mSlots[slot].generation + 1) << 5) | slot;
+    }
+
+    /**
+     * @brief Remove an entry
+     *
+     * @param handle  Handle returned by add()
+     * @return true   if the entry was removed
+     * @return false  if the handle is invalid or the entry was already removed
+     */
+    bool remove(int handle) {
+      int slot = handle & 31;
+      if (handle <= 0 || slot >= mCapacity || !(mUsed & (1u << slot)) || (handle >> 5) != mSlots[slot].generation + 1) return false;
+      mUsed &= ~(1u << slot);
+      mSlots[slot].generation = (mSlots[slot].generation + 1) & 0xFFFF;
+      return true;
+    }
+
+    /**
+     * @brief Call function for every entry
+     *
+     * @param function  Called with Entry&
+     */
+    template <typename F>
+    void forEach(F&& function) {
+      for (uint32_t bits = mUsed; bits; bits &= bits - 1) {
+        int slot = __builtin_ctz(bits);
+        if (mUsed & (1u << slot)) function(mSlots[slot].entry);
+      }
+    }
+
+    int size() const { return __builtin_popcount(mUsed); }
+    int capacity() const { return mCapacity; }
+
+  private:
+    Slot* mSlots;                               // storage of the entries
+    uint32_t mUsed = 0;                         // bit set for each used slot
+    uint8_t mCapacity;                          // number of slots
+};
+
+/**
+ * @brief VeCallbackRegistry with its own slots
+ */
+template <typename Entry, int Capacity>
+class VeCallbackList : public VeCallbackRegistry<Entry> {
+    static_assert(Capacity >= 0 && Capacity <= 32, "Capacity must be within 0..32");
+
+  public:
+    VeCallbackList() : VeCallbackRegistry<Entry>(mStorage, Capacity) { }
+
+  private:
+    VeCallbackSlot<Entry> mStorage[Capacity > 0 ? Capacity : 1] = { };
+};
+
+#endif // VEDIRECTCALLBACKS_H_
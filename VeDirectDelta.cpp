@@ -0,0 +1,179 @@
+/* VeDirectDelta.cpp
+ *
+ * Compact binary delta of TEXT frames for low-bandwidth uplinks.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - strings compared with the text of the baseline, a hash collision could hide a change
+ */
+
+#include <string.h>
+
+#include "VeDirectDelta.h"
+
+#define DELTA_STRING 0x40                   // record holds a string value
+#define DELTA_LABEL 0x3F                    // label id of a record
+
+static_assert(VE_LABEL_COUNT <= DELTA_LABEL + 1, "label ids must fit into DELTA_LABEL");
+
+/**
+ * @brief Writes an unsigned LEB128 varint
+ *
+ * @return uint8_t* Position after the varint or nullptr if it does not fit
+ */
+static uint8_t* putVarint(uint8_t* pos, const uint8_t* end, uint32_t value) {
+  do {
+    if (pos >= end) return nullptr;
+    uint8_t b = value & 0x7F;
+    value >>= 7;
+    *pos++ = value ? b | 0x80 : b;
+  } while (value);
+  return pos;
+}
+
+/**
+ * @brief Reads an unsigned LEB128 varint
+ *
+ * @return const uint8_t* Position after the varint or nullptr if it is truncated or too long
+ */
+static const uint8_t* getVarint(const uint8_t* pos, const uint8_t* end, uint32_t& value) {
+  value = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (pos >= end) return nullptr;
+    uint8_t b = *pos++;
+    value |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) return pos;
+  }
+  return nullptr;
+}
+
+static inline uint32_t zigzag(int32_t value) {
+  return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t unzigzag(uint32_t value) {
+  return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+/**
+ * @brief Forget everything, the next delta holds all labels
+ *
+ * @param state Baseline of the encoder or state of the decoder
+ */
+void veDeltaReset(VeDeltaState& state) {
+  memset(&state, 0, sizeof(state));
+}
+
+/**
+ * @brief Encode the changes of a snapshot since the baseline
+ * @details Call it from a frame callback with getSnapshot(), or with any other snapshot. Numeric
+ *          values are sent as difference to the baseline, strings and values that can't be
+ *          parsed as a whole. On success the written delta is applied to the baseline, in the
+ *          same way as veDeltaDecode of the receiver. Pass a copy to encode against a fixed
+ *          baseline. Does not allocate memory and needs no copy of the state.
+ *
+ * @param snapshot  Frame to encode
+ * @param baseline  Values known to the receiver
+ * @param buffer    Output buffer
+ * @param size      Size of buffer
+ * @return int      Number of bytes written or -1 if buffer is too small (baseline is untouched)
+ */
+int veDeltaEncode(const VeDirectFrameHandlerBase::VeStore& snapshot, VeDeltaState& baseline, uint8_t* buffer, size_t size) {
+  const uint8_t* end = buffer + size;
+  uint8_t* pos = putVarint(buffer, end, snapshot.frame);
+  if (!pos) return -1;
+
+  // each label is compared with its own baseline value only, so the baseline stays untouched
+  // while encoding and the written delta is applied to it at the end
+  for (uint8_t label = 0; label < VE_LABEL_COUNT; label++) {
+    int slot = snapshot.slotOf(label);
+    if (slot < 0 || label == VE_LABEL_CHECKSUM) continue;
+    uint32_t bit = 1u << (label % 32);
+    uint8_t word = label / 32;
+
+    if (snapshot.isTyped(slot)) {
+      int32_t value = snapshot.typedValue[slot];
+      int32_t old = (baseline.numeric[word] & bit) ? baseline.value[label] : 0;
+      if ((baseline.numeric[word] & bit) && old == value) continue;
+      if (pos >= end) return -1;
+      *pos++ = label;
+      pos = putVarint(pos, end, zigzag((int32_t)((uint32_t)value - (uint32_t)old)));
+      if (!pos) return -1;
+      continue;
+    }
+
+    const char* text = snapshot.data[slot].veValue;
+    if ((baseline.string[word] & bit) && strcmp(baseline.text[label], text) == 0) continue;
+    size_t len = strlen(text);
+    if ((size_t)(end - pos) < len + 2) return -1;
+    *pos++ = DELTA_STRING | label;
+    *pos++ = (uint8_t)len;
+    memcpy(pos, text, len);
+    pos += len;
+  }
+
+  veDeltaDecode(buffer, pos - buffer, baseline, nullptr, nullptr);
+  return pos - buffer;
+}
+
+/**
+ * @brief Apply a delta to the state of the receiver
+ * @details Numeric and string values are updated in state, the changed string values are also
+ *          passed to the callback.
+ *
+ * @param buffer            Delta as written by veDeltaEncode
+ * @param len               Length of the delta
+ * @param state             State of the receiver, updated only if the delta is valid
+ * @param cbFunction        Called for each string value, may be nullptr
+ * @param cbAdditionalData
+ * @return int              Number of changed labels or -1 if the delta is malformed
+ */
+int veDeltaDecode(const uint8_t* buffer, size_t len, VeDeltaState& state, deltaStringCallback cbFunction, void* cbAdditionalData) {
+  const uint8_t* end = buffer + len;
+  uint32_t frame;
+  const uint8_t* pos = getVarint(buffer, end, frame);
+  if (!pos) return -1;
+
+  // validate the whole delta first, so a broken one does not leave a half updated state
+  int records = 0;
+  for (const uint8_t* p = pos; p < end; records++) {
+    uint8_t tag = *p++;
+    if ((tag & ~(DELTA_STRING | DELTA_LABEL)) || (tag & DELTA_LABEL) >= VE_LABEL_COUNT) return -1;
+    if (tag & DELTA_STRING) {
+      if (p >= end || (size_t)(end - p) < (size_t)*p + 1) return -1;
+      if (*p >= valueLen) return -1;
+      p += *p + 1;
+    } else {
+      uint32_t value;
+      p = getVarint(p, end, value);
+      if (!p) return -1;
+    }
+  }
+
+  state.frame = frame;
+  while (pos < end) {
+    uint8_t tag = *pos++;
+    uint8_t label = tag & DELTA_LABEL;
+    uint32_t bit = 1u << (label % 32);
+    uint8_t word = label / 32;
+    if (tag & DELTA_STRING) {
+      uint8_t textLen = *pos++;
+      char* text = state.text[label];
+      memcpy(text, pos, textLen);
+      text[textLen] = 0;
+      pos += textLen;
+      state.string[word] |= bit;
+      state.numeric[word] &= ~bit;
+      if (cbFunction) cbFunction((VeLabel)label, text, textLen, cbAdditionalData);
+    } else {
+      uint32_t value;
+      pos = getVarint(pos, end, value);
+      int32_t old = (state.numeric[word] & bit) ? state.value[label] : 0;
+      state.value[label] = (int32_t)((uint32_t)old + (uint32_t)unzigzag(value));
+      state.numeric[word] |= bit;
+      state.string[word] &= ~bit;
+    }
+  }
+  return records;
+}
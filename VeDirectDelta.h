@@ -0,0 +1,41 @@
+/* VeDirectDelta.h
+ *
+ * Compact binary delta of TEXT frames for low-bandwidth uplinks.
+ *
+ * A delta holds the frame number and every known label whose value changed since the baseline:
+ *   varint frame number
+ *   per changed label:
+ *     numeric value   label id (0..63)          zigzag varint of the difference to the baseline
+ *     string value    0x40 | label id, length,  the characters (values that can't be parsed too)
+ * Labels that are not part of enum VeLabel are not transferred.
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - keep the string values in the state instead of their hash
+ * 2026.10.14 - 0.3 - encode without a copy of the baseline, apply the delta on success
+ */
+
+#ifndef VEDIRECTDELTA_H_
+#define VEDIRECTDELTA_H_
+
+#include "VeDirectFrameHandler.h"
+
+/**
+ * @brief Values known to the receiver of the deltas
+ * @details The encoder keeps one for the last published frame, the decoder holds the same after
+ *          decoding the delta. Zero initialize it (or call veDeltaReset) to send everything.
+ */
+struct VeDeltaState {
+  int32_t value[VE_LABEL_COUNT];              // numeric value of each label
+  char text[VE_LABEL_COUNT][valueLen];        // string value of each label
+  uint32_t numeric[(VE_LABEL_COUNT + 31) / 32]; // bit set if value is known
+  uint32_t string[(VE_LABEL_COUNT + 31) / 32];  // bit set if text is known
+  uint32_t frame;                             // frame number of the last delta
+};
+
+typedef void (*deltaStringCallback)(VeLabel, const char*, uint8_t, void*);
+
+void veDeltaReset(VeDeltaState& state);
+int veDeltaEncode(const VeDirectFrameHandlerBase::VeStore& snapshot, VeDeltaState& baseline, uint8_t* buffer, size_t size);
+int veDeltaDecode(const uint8_t* buffer, size_t len, VeDeltaState& state, deltaStringCallback cbFunction, void* cbAdditionalData);
+
+#endif // VEDIRECTDELTA_H_
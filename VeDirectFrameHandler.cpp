@@ -32,40 +32,98 @@
  * 2020.08.20 - 0.3 - corrected #include reference
  * 2022.05.16 - 0.4 - drop arduino requirements, add cmake, add pedantic, chksum without \t\n\s
  * 2022.05.17 - 0.5 - add support for the HEX protocol
+ * 2026.10.14 - 0.6 - add bulk rxData for buffer ingestion
+ * 2026.10.14 - 0.7 - hash index for the label lookup
+ * 2026.10.14 - 0.8 - typed store of the parsed values
+ * 2026.10.14 - 0.9 - compile-time sizing of the buffers, direct mode without tempData
+ * 2026.10.14 - 0.10 - double-buffered snapshots, commit by swapping
+ * 2026.10.14 - 0.11 - lock-free snapshot reads from another core or task
+ * 2026.10.14 - 0.12 - frame and label change callbacks for TEXT frames
+ * 2026.10.14 - 0.13 - decode HEX frames once, callbacks per response and register
+ * 2026.10.14 - 0.14 - error and statistics counters instead of printf, optional log callback
+ * 2026.10.14 - 0.15 - optional latency and throughput metrics
+ * 2026.10.14 - 0.16 - constexpr table-driven bulk parser, selected by VEDIRECT_TABLE_PARSER
+ * 2026.10.14 - 0.17 - intern the label names to label ids while receiving them
+ * 2026.10.14 - 0.18 - resync mode, reject malformed records and restart frames at PID
+ * 2026.10.14 - 0.19 - partial acceptance of the plausible records of frames with an invalid checksum
+ * 2026.10.14 - 0.20 - optional queue of HEX messages, callbacks called by pollHex
+ * 2026.10.14 - 0.21 - fixed capacity callback registry with removal and callable references
+ * 2026.10.14 - 0.22 - optional publish policies filtering the label callbacks
+ * 2026.10.14 - 0.23 - partial frames never add labels
+ * 2026.10.14 - 0.24 - typed values per slot, sized by MaxLabels
+ * 2026.10.14 - 0.25 - callback capacities as template parameter, handles are always > 0
+ * 2026.10.14 - 0.26 - slot bitsets sized by MaxLabels, shared label slots, no <atomic> on AVR
  */
 
-#include <ctype.h>
-#include <cstdint>
-#include <stdio.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "VeDirectFrameHandler.h"
+#include "VeDirectPublish.h"
 
-#ifndef DEBUG_MODE
-#define DEBUG_MODE false
+#ifdef VEDIRECT_LOG
+#define VE_LOG(message, value) do { if (mLogCallBack) mLogCallBack(message, value, mLogData); } while (0)
+#else
+#define VE_LOG(message, value) do { } while (0)
 #endif
 
-// initial number - buffer is dynamically increased if necessary
-#define MAX_HEX_CALLBACK 10
+// attempts of readSnapshot to get a copy without a frame committed in between
+#define SNAPSHOT_READ_RETRIES 4
 
-// Helper functions for the HEX protocol
-#define ascii2hex(v) (v-48-(v>='A'?7:0))
-#define hex2byte(b) (ascii2hex(*(b)))*16+((ascii2hex(*(b+1))))
+// ASCII upper case, without the locale lookup of toupper
+static inline uint8_t upperCase(uint8_t c) {
+  return (uint8_t)(c - 'a') < 26 ? c - ('a' - 'A') : c;
+}
+
+/**
+ * @brief Check the characters of a name, upper case letters, digits, # and _
+ */
+static bool validName(const char* name) {
+  for (const uint8_t* p = (const uint8_t*)name; *p; p++) {
+    uint8_t c = upperCase(*p);
+    if (!((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '#' || c == '_')) return false;
+  }
+  return true;
+}
 
-// The name of the record that contains the checksum.
-// It's upper case as we upper all chars in the progress.
-static constexpr char checksumTagName[] = "CHECKSUM";
+/**
+ * @brief Check the characters of a value, printable ASCII only
+ */
+static bool validValue(const char* value) {
+  for (const uint8_t* p = (const uint8_t*)value; *p; p++) {
+    if (*p < 0x20 || *p > 0x7E) return false;
+  }
+  return true;
+}
 
 /**
  * @brief Construct a new Ve Direct Frame Handler:: Ve Direct Frame Handler object
+ * @details The buffers are owned by the caller (see VeDirectFrameHandlerT) and must be zero initialized.
+ *
+ * @param stores        Front and back store
+ * @param maxLabels     Number of slots in each store
+ * @param indexLen      Size of the label index of each store, must be a power of 2
+ * @param maxFrameLines Maximum number of records per frame
+ * @param hexBuffer     Buffer for hex frames
+ * @param hexLen        Size of hexBuffer
+ * @param frameBits     3 slot bitsets of (maxLabels + 31) / 32 words for the current frame
+ * @param callbacks     Slots of the callback registries
  */
-VeDirectFrameHandler::VeDirectFrameHandler() {}
+VeDirectFrameHandlerBase::VeDirectFrameHandlerBase(VeStore* stores, uint8_t maxLabels, uint16_t indexLen,
+                                                   uint8_t maxFrameLines, char* hexBuffer, int hexLen,
+                                                   uint32_t* frameBits, const VeCallbackSlots& callbacks)
+  : veData(stores[0].data), veHexBuffer(hexBuffer), mStores(stores), mMaxLabels(maxLabels),
+    mWords((maxLabels + 31) / 32), mIndexMask(indexLen - 1), mMaxFrameLines(maxFrameLines), mHexLen(hexLen),
+    mTouched(frameBits), mStale(frameBits + mWords), mPlausible(frameBits + 2 * mWords),
+    mHexCallBacks(callbacks.hex, callbacks.hexCapacity),
+    mHexMessageCallBacks(callbacks.hexMessage, callbacks.hexMessageCapacity),
+    mFrameCallBacks(callbacks.frame, callbacks.frameCapacity),
+    mLabelCallBacks(callbacks.label, callbacks.labelCapacity) {}
 
 /**
  * @brief Destroy the Ve Direct Frame Handler:: Ve Direct Frame Handler object
  */
-VeDirectFrameHandler::~VeDirectFrameHandler() {
-      if (veHexCallBacks) delete veHexCallBacks;
+VeDirectFrameHandlerBase::~VeDirectFrameHandlerBase() {
 }
 
 /**
@@ -74,14 +132,14 @@ VeDirectFrameHandler::~VeDirectFrameHandler() {
  * @return true on new data
  * @return false when no data available
  */
-bool VeDirectFrameHandler::isDataAvailable() {
+bool VeDirectFrameHandlerBase::isDataAvailable() {
   return newDataAvailable;
 }
 
 /**
  * @brief Clear state and wait for new data
  */
-void VeDirectFrameHandler::clearData() {
+void VeDirectFrameHandlerBase::clearData() {
   newDataAvailable = false;
 }
 
@@ -91,25 +149,24 @@ void VeDirectFrameHandler::clearData() {
  *
  * @param inbyte Input byte to store in the tmp memory
  */
-void VeDirectFrameHandler::rxData(uint8_t inbyte) {
+void VeDirectFrameHandlerBase::rxData(uint8_t inbyte) {
+  mStats.bytes++;
+  rxByte(inbyte);
+}
+
+/**
+ * @brief Byte-wise state machine of rxData
+ *
+ * @param inbyte Input byte to store in the tmp memory
+ */
+void VeDirectFrameHandlerBase::rxByte(uint8_t inbyte) {
   if ( inbyte == ':' && mState != CHECKSUM ) {
     veLastTextState = mState; // hex frame can interrupt TEXT
     mState = RECORD_HEX;
     veHEnd = 0;
   }
   if (mState != RECORD_HEX) {
-    if(DEBUG_MODE) printf("Checksum = %3d ", mChecksum);
     mChecksum += inbyte;
-    //mChecksum = (mChecksum + inbyte) & 255;
-    if(DEBUG_MODE) {
-      if (isprint(inbyte))      printf("+ %3d (%c)  ", inbyte, inbyte);
-      else if (inbyte == '\n')  printf("+ %3d (\\n) ", inbyte);
-      else if (inbyte == '\r')  printf("+ %3d (\\r) ", inbyte);
-      else if (inbyte == '\t')  printf("+ %3d (\\t) ", inbyte);
-      else printf("+ %3d (.)  ", inbyte);
-      printf("= %3d  ", mChecksum);
-      printf("mState = %d\n", mState);
-    }
   }
 
   switch(mState) {
@@ -118,7 +175,7 @@ void VeDirectFrameHandler::rxData(uint8_t inbyte) {
       // The next received byte will be part of the frame
       switch(inbyte) {
         case '\n':
-          if(DEBUG_MODE) printf("Transition from IDLE to RECORD_BEGIN\n");
+          mLineStart = mChecksum - '\r' - '\n';
           mState = RECORD_BEGIN;
           break;
         default: // skip \r and incomplete line data
@@ -126,30 +183,20 @@ void VeDirectFrameHandler::rxData(uint8_t inbyte) {
       }
       break;
     case RECORD_BEGIN:
-      // Start the record of the label name
-      mTextPointer = mName;
-      *mTextPointer++ = inbyte;
-      mState = RECORD_NAME;
+      recordBegin(inbyte);
       break;
     case RECORD_NAME:
       // The record name is being received, terminated by a \t
       switch(inbyte) {
         case '\t': // End of field name (sperator)
-          // the Checksum record indicates a EOR
-          if (mTextPointer < (mName + sizeof(mName))) {
-            *mTextPointer = 0; // Zero terminate
-            if (strcmp(mName, checksumTagName) == 0) {
-              mState = CHECKSUM;
-              break;
-            }
-          }
-          mTextPointer = mValue; // Reset value pointer to record the value
-          mState = RECORD_VALUE;
+          recordNameEnd();
           break;
         default:
           // add byte to name, but do no overflow
-          if (mTextPointer < (mName + sizeof(mName)-1))
-              *mTextPointer++ = toupper(inbyte);
+          if (mTextPointer < (mName + sizeof(mName)-1)) {
+            *mTextPointer++ = inbyte = upperCase(inbyte);
+            mNameHash = veLabelHashStep(mNameHash, inbyte);
+          } else mTruncated = true;
           break;
       }
       break;
@@ -157,12 +204,7 @@ void VeDirectFrameHandler::rxData(uint8_t inbyte) {
       // The record value is being received. The \n indicates a new record.
       switch(inbyte) {
         case '\n':
-          // forward record, only if it could be stored completely
-          if (mTextPointer < (mValue + sizeof(mValue))) {
-            *mTextPointer = 0; // make zero ended
-            textRxEvent(mName, mValue);
-          }
-          mState = RECORD_BEGIN;
+          recordValueEnd();
           break;
         case '\r': // Ignore
           break;
@@ -170,14 +212,12 @@ void VeDirectFrameHandler::rxData(uint8_t inbyte) {
           // add byte to value, but do no overflow
           if (mTextPointer < (mValue + sizeof(mValue)-1))
             *mTextPointer++ = inbyte;
+          else mTruncated = true;
           break;
       }
       break;
     case CHECKSUM:
-      if (mChecksum != 0) printf("[CHECKSUM] Invalid frame - checksum is %d\n", mChecksum);
-      mState = IDLE;
-      frameEndEvent(ignoreCheckSum || mChecksum == 0);
-      mChecksum = 0;
+      checksumEvent();
       break;
     case RECORD_HEX:
       mState = hexRxEvent(inbyte);
@@ -186,88 +226,751 @@ void VeDirectFrameHandler::rxData(uint8_t inbyte) {
 }
 
 /**
- * @brief This function is called every time a new name/value is successfully parsed.  It writes the values to the temporary buffer.
+ * @brief Start the record of the label name with its first byte
+ *
+ * @param inbyte First byte of the name, stored as received
+ */
+void VeDirectFrameHandlerBase::recordBegin(uint8_t inbyte) {
+#ifdef VEDIRECT_METRICS
+  if (!mFrameOpen && mClock) {
+    mFrameStart = mClock();
+    mFrameOpen = true;
+  }
+#endif
+  mTextPointer = mName;
+  *mTextPointer++ = inbyte;
+  mNameHash = veLabelHashStep(veLabelHashSeed, inbyte);
+  mTruncated = false;
+  mState = RECORD_NAME;
+}
+
+/**
+ * @brief The \t after the name was received, the value or the checksum byte follows
+ * @details The name was hashed while receiving it, so looking up its label id is one probe
+ *          of the table of the known labels.
+ */
+void VeDirectFrameHandlerBase::recordNameEnd() {
+  bool truncated = mTruncated;
+  if (mTruncated) {
+    mStats.nameTruncations++;
+    VE_LOG("[TEXT] Name truncated", nameLen - 1);
+    mTruncated = false;
+  }
+  *mTextPointer = 0; // Zero terminate
+  // a 0 byte ends the stored name early, the hash must match the stored name
+  if (strlen(mName) != (size_t)(mTextPointer - mName)) mNameHash = veLabelHash(mName);
+  if (resync && (truncated || !validName(mName))) {
+    rejectFrame();
+    mState = IDLE;   // skip the value
+    return;
+  }
+  mLabel = veLabelFromHash(mNameHash, mName);
+  // the Checksum record indicates a EOR
+  if (mLabel == VE_LABEL_CHECKSUM) {
+    mState = CHECKSUM;
+    return;
+  }
+  if (resync) restartFrame();
+  mTextPointer = mValue; // Reset value pointer to record the value
+  mState = RECORD_VALUE;
+}
+
+/**
+ * @brief The \n after the value was received, store the record
+ */
+void VeDirectFrameHandlerBase::recordValueEnd() {
+  bool truncated = mTruncated;
+  if (mTruncated) {
+    mStats.valueTruncations++;
+    VE_LOG("[TEXT] Value truncated", valueLen - 1);
+    mTruncated = false;
+  }
+  mLineStart = mChecksum - '\r' - '\n';
+  mState = RECORD_BEGIN;
+  *mTextPointer = 0; // make zero ended
+  if (resync && (truncated || !validValue(mValue))) {
+    rejectFrame();
+    return;
+  }
+  textRxEvent(mName, mValue);
+}
+
+/**
+ * @brief Drop the records of the current frame after a malformed record (resync mode)
+ * @details The frame can't pass its checksum any more, dropping it now lets the parser pick up
+ *          the next frame by its PID instead of merging records until the checksum fails.
+ */
+void VeDirectFrameHandlerBase::rejectFrame() {
+  mStats.resyncs++;
+  VE_LOG("[RESYNC] Malformed record", frameIndex);
+  frameEndEvent(false);
+}
+
+/**
+ * @brief Start a new frame at this record if it can only be the first of a frame (resync mode)
+ * @details A frame starts with PID, and no label appears twice in one frame. If either shows up
+ *          in the middle of a frame, the checksum record of the previous frame was lost (or the
+ *          parser started inside a frame). Its records are dropped and the checksum restarts
+ *          with the \r\n in front of this record, so the new frame can still pass its checksum.
+ */
+void VeDirectFrameHandlerBase::restartFrame() {
+  bool first = mLabel == VE_LABEL_PID;
+  if (!first && frameIndex > 0) {
+    VeStore& back = mStores[mFront ^ 1];
+    int slot = mLabel < VE_LABEL_COUNT ? back.slotOf(mLabel) : indexLabel(back, mName, mNameHash, false);
+    first = slot >= 0 && (mTouched[slot / 32] & (1u << (slot % 32)));
+  }
+  if (!first) return;
+  if (frameIndex > 0) {
+    mStats.resyncs++;
+    VE_LOG("[RESYNC] Frame restarted at", mLabel);
+    frameEndEvent(false);
+  }
+  mChecksum -= mLineStart;
+  mLineStart = 0;
+}
+
+/**
+ * @brief The checksum byte was received and added, end the frame
+ */
+void VeDirectFrameHandlerBase::checksumEvent() {
+  if (mChecksum != 0) {
+    mStats.textChecksumErrors++;
+    VE_LOG("[CHECKSUM] Invalid frame - checksum is", mChecksum);
+  }
+  mState = IDLE;
+  frameEndEvent(ignoreCheckSum || mChecksum == 0);
+  mChecksum = 0;
+}
+
+/**
+ * @brief Parses a whole buffer of serial data into the frame
+ * @details Produces the same frames as feeding every byte to rxData(uint8_t). The parser is
+ *          selected at compile time, VEDIRECT_TABLE_PARSER selects the table-driven one.
+ *
+ * @param buffer Input bytes as read from the serial port
+ * @param len    Number of bytes in buffer
+ */
+void VeDirectFrameHandlerBase::rxData(const uint8_t* buffer, size_t len) {
+  mStats.bytes += len;
+#ifdef VEDIRECT_TABLE_PARSER
+  rxTable(buffer, len);
+#else
+  rxRuns(buffer, len);
+#endif
+}
+
+/**
+ * @brief Bulk parser based on the byte-wise state machine
+ * @details Consumes runs of name, value and hex characters in one go. Only the delimiters and
+ *          the IDLE, RECORD_BEGIN and CHECKSUM states go through the byte-wise state machine.
+ *          Name and value runs still have to touch every byte for the checksum, so the scan
+ *          for the delimiters is done in the same pass. HEX runs are not part of the checksum
+ *          and are located with memchr.
+ *
+ * @param buffer Input bytes as read from the serial port
+ * @param len    Number of bytes in buffer
+ */
+void VeDirectFrameHandlerBase::rxRuns(const uint8_t* buffer, size_t len) {
+  const uint8_t* pos = buffer;
+  const uint8_t* end = buffer + len;
+
+  while (pos < end) {
+    switch(mState) {
+      case RECORD_NAME: {
+        // add bytes to name up to the \t seperator, but do no overflow
+        char* limit = mName + sizeof(mName) - 1;
+        uint8_t checksum = mChecksum;
+        uint32_t hash = mNameHash;
+        while (pos < end && *pos != '\t' && *pos != ':') {
+          checksum += *pos;
+          if (mTextPointer < limit) {
+            uint8_t c = upperCase(*pos);
+            *mTextPointer++ = c;
+            hash = veLabelHashStep(hash, c);
+          } else mTruncated = true;
+          pos++;
+        }
+        mChecksum = checksum;
+        mNameHash = hash;
+        break;
+      }
+      case RECORD_VALUE: {
+        // add bytes to value up to the end of the line, but do no overflow
+        char* limit = mValue + sizeof(mValue) - 1;
+        uint8_t checksum = mChecksum;
+        while (pos < end && *pos != '\n' && *pos != '\r' && *pos != ':') {
+          checksum += *pos;
+          if (mTextPointer < limit) *mTextPointer++ = *pos;
+          else mTruncated = true;
+          pos++;
+        }
+        mChecksum = checksum;
+        break;
+      }
+      case RECORD_HEX: {
+        // copy everything up to the end of the hex frame, but leave the byte
+        // that would overflow the buffer to the byte-wise path
+        size_t room = (size_t)(mHexLen - 1 - veHEnd);
+        size_t span = (size_t)(end - pos) < room ? (size_t)(end - pos) : room;
+        const uint8_t* stop = (const uint8_t*)memchr(pos, '\n', span);
+        if (stop) span = stop - pos;
+        stop = (const uint8_t*)memchr(pos, ':', span);
+        if (stop) span = stop - pos;
+        memcpy(veHexBuffer + veHEnd, pos, span);
+        veHEnd += span;
+        pos += span;
+        break;
+      }
+      default:
+        break;
+    }
+    if (pos < end) rxByte(*pos++);
+  }
+}
+
+// Character classes and actions of the table-driven parser, both tables are built at compile time
+enum CharClass : uint8_t {
+  CC_TEXT,                                  // any other byte
+  CC_TAB,                                   // \t ends the name
+  CC_LF,                                    // \n ends the value, starts a record
+  CC_CR,                                    // \r is ignored in values
+  CC_COLON,                                 // : starts a HEX frame
+  CC_COUNT
+};
+
+enum Action : uint8_t {
+  A_SKIP,                                   // only add to the checksum
+  A_BEGIN,                                  // start of a record
+  A_NAME_FIRST,                             // first byte of a name
+  A_NAME,                                   // name byte
+  A_NAME_END,                               // \t after the name
+  A_VALUE,                                  // value byte
+  A_VALUE_END,                              // \n after the value
+  A_CHECKSUM,                               // checksum byte
+  A_HEX_START,                              // : starting a HEX frame
+  A_HEX,                                    // HEX byte
+  A_HEX_END,                                // \n after a HEX frame
+  A_COUNT
+};
+
+struct CharClassTable {
+  uint8_t cls[256];
+};
+
+static constexpr CharClassTable makeCharClasses() {
+  CharClassTable table = { };
+  table.cls['\t'] = CC_TAB;
+  table.cls['\n'] = CC_LF;
+  table.cls['\r'] = CC_CR;
+  table.cls[':'] = CC_COLON;
+  return table;
+}
+
+static constexpr CharClassTable charClasses = makeCharClasses();
+
+// next action per state (rows in the order of enum States) and character class
+static constexpr uint8_t actions[6][CC_COUNT] = {
+  //  CC_TEXT       CC_TAB        CC_LF         CC_CR         CC_COLON
+  { A_SKIP,       A_SKIP,       A_BEGIN,      A_SKIP,       A_HEX_START },   // IDLE
+  { A_NAME_FIRST, A_NAME_FIRST, A_NAME_FIRST, A_NAME_FIRST, A_HEX_START },   // RECORD_BEGIN
+  { A_NAME,       A_NAME_END,   A_NAME,       A_NAME,       A_HEX_START },   // RECORD_NAME
+  { A_VALUE,      A_VALUE,      A_VALUE_END,  A_SKIP,       A_HEX_START },   // RECORD_VALUE
+  { A_CHECKSUM,   A_CHECKSUM,   A_CHECKSUM,   A_CHECKSUM,   A_CHECKSUM  },   // CHECKSUM
+  { A_HEX,        A_HEX,        A_HEX_END,    A_HEX,        A_HEX_START },   // RECORD_HEX
+};
+
+// mask of the byte added to the checksum per action, HEX frames are not part of it
+static constexpr uint8_t checksumMask[A_COUNT] = {
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00
+};
+
+/**
+ * @brief Table-driven bulk parser
+ * @details Every byte is mapped to its character class and, with the state, to the next action
+ *          by two lookups. The checksum is added with a mask instead of a branch. Runs of name,
+ *          value and hex bytes are consumed in tight loops that only compare the action.
+ *
+ * @param buffer Input bytes as read from the serial port
+ * @param len    Number of bytes in buffer
+ */
+void VeDirectFrameHandlerBase::rxTable(const uint8_t* buffer, size_t len) {
+  static_assert(IDLE == 0 && RECORD_BEGIN == 1 && RECORD_NAME == 2 && RECORD_VALUE == 3 &&
+                CHECKSUM == 4 && RECORD_HEX == 5, "rows of actions follow enum States");
+  const uint8_t* pos = buffer;
+  const uint8_t* end = buffer + len;
+
+  while (pos < end) {
+    uint8_t inbyte = *pos++;
+    uint8_t action = actions[mState][charClasses.cls[inbyte]];
+    mChecksum += inbyte & checksumMask[action];
+    switch (action) {
+      case A_SKIP:
+        break;
+      case A_BEGIN:
+        mLineStart = mChecksum - '\r' - '\n';
+        mState = RECORD_BEGIN;
+        break;
+      case A_NAME_FIRST:
+        recordBegin(inbyte);
+        break;
+      case A_NAME: {
+        const uint8_t* row = actions[RECORD_NAME];
+        char* limit = mName + sizeof(mName) - 1;
+        uint8_t checksum = mChecksum;
+        uint32_t hash = mNameHash;
+        for (;;) {
+          if (mTextPointer < limit) {
+            uint8_t c = upperCase(inbyte);
+            *mTextPointer++ = c;
+            hash = veLabelHashStep(hash, c);
+          } else mTruncated = true;
+          if (pos >= end || row[charClasses.cls[*pos]] != A_NAME) break;
+          inbyte = *pos++;
+          checksum += inbyte;
+        }
+        mChecksum = checksum;
+        mNameHash = hash;
+        break;
+      }
+      case A_NAME_END:
+        recordNameEnd();
+        break;
+      case A_VALUE: {
+        const uint8_t* row = actions[RECORD_VALUE];
+        char* limit = mValue + sizeof(mValue) - 1;
+        uint8_t checksum = mChecksum;
+        for (;;) {
+          if (mTextPointer < limit) *mTextPointer++ = inbyte;
+          else mTruncated = true;
+          if (pos >= end || row[charClasses.cls[*pos]] != A_VALUE) break;
+          inbyte = *pos++;
+          checksum += inbyte;
+        }
+        mChecksum = checksum;
+        break;
+      }
+      case A_VALUE_END:
+        recordValueEnd();
+        break;
+      case A_CHECKSUM:
+        checksumEvent();
+        break;
+      case A_HEX_START:
+        veLastTextState = mState; // hex frame can interrupt TEXT
+        veHEnd = 0;
+        mState = hexRxEvent(inbyte);
+        break;
+      case A_HEX: {
+        // the byte that would overflow the buffer goes to hexRxEvent
+        const uint8_t* row = actions[RECORD_HEX];
+        const uint8_t* stop = pos + (mHexLen - 2 - veHEnd);
+        if (stop > end) stop = end;
+        if (pos > stop) {
+          mState = hexRxEvent(inbyte);
+          break;
+        }
+        veHexBuffer[veHEnd++] = inbyte;
+        while (pos < stop && row[charClasses.cls[*pos]] == A_HEX) veHexBuffer[veHEnd++] = *pos++;
+        break;
+      }
+      case A_HEX_END:
+        mState = hexRxEvent(inbyte);
+        break;
+    }
+  }
+}
+
+/**
+ * @brief This function is called every time a new name/value is successfully parsed.  It writes the values to the back store.
+ * @details Before the first record of a frame, the back store is brought up to date with the front store.
+ *          Known labels find their slot by the label id, only unknown labels use the hash index.
  *
  * @param mName     Name of the element
  * @param mValue    Value of the element
  */
-void VeDirectFrameHandler::textRxEvent(char * mName, char * mValue) {
-  if (frameIndex < frameLen) {                       // prevent overflow
-    strcpy(tempData[frameIndex].veName, mName);      // copy name to temporary buffer
-    strcpy(tempData[frameIndex].veValue, mValue);    // copy value to temporary buffer
-    frameIndex++;
+void VeDirectFrameHandlerBase::textRxEvent(char * mName, char * mValue) {
+  if (frameIndex >= mMaxFrameLines) {                      // prevent overflow
+    mStats.droppedRecords++;
+    return;
+  }
+  if (frameIndex++ == 0) syncBackStore();
+
+  VeStore& back = mStores[mFront ^ 1];
+  int slot = back.slotOf(mLabel);
+  if (slot < 0) slot = indexLabel(back, mName, mNameHash, true);
+  if (slot < 0) {                                          // new names are dropped once the store is full
+    mStats.droppedRecords++;
+    return;
+  }
+  strcpy(back.data[slot].veValue, mValue);
+  uint32_t slotBit = 1u << (slot % 32);
+  mTouched[slot / 32] |= slotBit;
+  mPlausible[slot / 32] &= ~slotBit;
+
+  uint8_t label = mLabel;
+  if (label >= VE_LABEL_COUNT) return;
+  bool parsed = veParseValue(veLabels[label].type, mValue, back.typedValue[slot]);
+  if (parsed) back.typedValid[slot / 32] |= slotBit;
+  else back.typedValid[slot / 32] &= ~slotBit;
+  // the record would pass as received correctly: a known label with a value of its grammar
+  if (partialAccept && (veLabels[label].type == VE_TYPE_STRING ? validValue(mValue) : parsed)) mPlausible[slot / 32] |= slotBit;
+}
+
+/**
+ * @brief Copy the slots that differ from the front store into the back store
+ * @details These are the slots written by the last frame: after a valid frame its records are
+ *          missing in the new back store, after an invalid frame they have to be reverted.
+ *          The label index only changes with the number of labels.
+ */
+void VeDirectFrameHandlerBase::syncBackStore() {
+  VeStore& front = mStores[mFront];
+  VeStore& back = mStores[mFront ^ 1];
+  for (int i = 0; i < mWords; i++) {
+    for (uint32_t bits = mStale[i]; bits; bits &= bits - 1) revertSlot(i * 32 + __builtin_ctz(bits));
+    mStale[i] = 0;
+  }
+  if (back.end != front.end) {
+    memcpy(back.labelIndex, front.labelIndex, mIndexMask + 1);
+    back.end = front.end;
+  }
+  memcpy(back.unverified, front.unverified, mWords * sizeof(uint32_t));
+  back.frame = front.frame;
+}
+
+/**
+ * @brief Copy one slot of the front store into the back store, including its typed value
+ *
+ * @param slot  Slot to revert, a slot beyond the front store only drops its typed value
+ */
+void VeDirectFrameHandlerBase::revertSlot(int slot) {
+  VeStore& front = mStores[mFront];
+  VeStore& back = mStores[mFront ^ 1];
+  uint32_t bit = 1u << (slot % 32);
+  if (slot >= front.end) {                                 // label only known to an invalid frame
+    back.typedValid[slot / 32] &= ~bit;
+    return;
+  }
+  back.data[slot] = front.data[slot];
+  back.slotLabel[slot] = front.slotLabel[slot];
+  back.typedValue[slot] = front.typedValue[slot];
+  back.typedValid[slot / 32] = (back.typedValid[slot / 32] & ~bit) | (front.typedValid[slot / 32] & bit);
+}
+
+/**
+ * @brief Keep only the plausible records of a frame with an invalid checksum (partialAccept)
+ * @details All other records of the frame are reverted to the front store. Labels new to this
+ *          frame are always dropped: a corrupted name (e.g. H21 received as H1) would otherwise
+ *          stay in the store for good, as the label index can't remove single labels.
+ *
+ * @return true   if plausible records are left to commit
+ * @return false  if nothing is left, the back store equals the front store again
+ */
+bool VeDirectFrameHandlerBase::acceptPlausible() {
+  VeStore& front = mStores[mFront];
+  VeStore& back = mStores[mFront ^ 1];
+  bool dropNew = back.end > front.end;
+  bool left = false;
+  for (int i = 0; i < mWords; i++) {
+    for (uint32_t bits = mTouched[i]; bits; bits &= bits - 1) {
+      int slot = i * 32 + __builtin_ctz(bits);
+      if ((mPlausible[i] & (1u << (slot % 32))) && slot < front.end) continue;
+      revertSlot(slot);
+      mTouched[i] &= ~(1u << (slot % 32));
+    }
+    left |= mTouched[i] != 0;
+  }
+  if (dropNew) {
+    memcpy(back.labelIndex, front.labelIndex, mIndexMask + 1);
+    back.end = front.end;
+  }
+  return left;
+}
+
+/**
+ * @brief Find the slot of a label in a store using the hash index
+ * @details The index uses open addressing with linear probing. As labels are never
+ *          removed from the store, an unused bucket ends the probe sequence.
+ *
+ * @param store  Store to search
+ * @param name   Name of the label
+ * @param hash   veLabelHash of name
+ * @param insert Add the label to the store if it does not exist yet
+ * @return int   Slot in the store or -1 if not found (or the store is full)
+ */
+int VeDirectFrameHandlerBase::indexLabel(VeStore& store, const char* name, uint32_t hash, bool insert) {
+  uint16_t bucket = (uint16_t)(hash ^ (hash >> 16)) & mIndexMask;
+  while (store.labelIndex[bucket]) {
+    int slot = store.labelIndex[bucket] - 1;
+    if (strcmp(store.data[slot].veName, name) == 0) return slot;
+    bucket = (bucket + 1) & mIndexMask;
+  }
+  if (!insert || store.end >= mMaxLabels) return -1;
+  strcpy(store.data[store.end].veName, name);              // write new Name to the store
+  VeLabel label = veLabelFromHash(hash, name);
+  store.slotLabel[store.end] = label;
+  if (label < VE_LABEL_COUNT) store.labelSlot[label] = store.end + 1;
+  store.labelIndex[bucket] = store.end + 1;
+  return store.end++;                                      // increment end of the store
+}
+
+/**
+ * @brief Find the slot of a label in the public buffer
+ *
+ * @param name  Name of the label (upper case, as received)
+ * @return int  Index into veData or -1 if the label was not received yet
+ */
+int VeDirectFrameHandlerBase::findLabel(const char* name) {
+  return indexLabel(mStores[mFront], name, veLabelHash(name), false);
+}
+
+/**
+ * @brief Get the current value of a label
+ *
+ * @param name          Name of the label (upper case, as received)
+ * @return const char*  Value from the public buffer or nullptr if the label was not received yet
+ */
+const char* VeDirectFrameHandlerBase::getValue(const char* name) {
+  int slot = findLabel(name);
+  return slot < 0 ? nullptr : veData[slot].veValue;
+}
+
+/**
+ * @brief Get the typed value of a known label
+ * @details The values are parsed once when the frame is received, the unit of each label is
+ *          documented at enum VeLabel. String labels (e.g. SER#) are never available.
+ *
+ * @param label   Label id
+ * @param value   Parsed value, untouched if not available
+ * @return true   if the label was received with a valid value
+ * @return false  if the label was not received yet or the value could not be parsed
+ */
+bool VeDirectFrameHandlerBase::getTyped(VeLabel label, int32_t& value) {
+  return mStores[mFront].getTyped(label, value);
+}
+
+/**
+ * @brief Copy the typed values of a store into the by label layout of VeTypedData
+ * @details The store keeps them per slot, so only the received labels take memory.
+ *
+ * @param typed   Output, labels without a valid value are 0
+ */
+void VeDirectFrameHandlerBase::VeStore::copyTyped(VeTypedData& typed) const {
+  typed = VeTypedData();
+  for (int slot = 0; slot < end; slot++) {
+    uint8_t label = slotLabel[slot];
+    if (!isTyped(slot) || label >= VE_LABEL_COUNT) continue;
+    typed.value[label] = typedValue[slot];
+    typed.valid[label / 32] |= 1u << (label % 32);
+  }
+}
+
+/**
+ * @brief Check if the value of a slot was received in a frame with a valid checksum
+ * @details With partialAccept, the plausible records of a frame with an invalid checksum are
+ *          committed as unverified. The flag is cleared by the next valid frame with the label.
+ *
+ * @param slot    Index into veData, see findLabel()
+ * @return true   if the value passed the checksum (or ignoreCheckSum is set)
+ * @return false  if it was accepted as plausible only, or the slot is not used
+ */
+bool VeDirectFrameHandlerBase::isVerified(int slot) {
+  const VeStore& front = mStores[mFront];
+  if (slot < 0 || slot >= front.end) return false;
+  return !(front.unverified[slot / 32] & (1u << (slot % 32)));
+}
+
+/**
+ * @brief Get the snapshot of the last valid frame
+ * @details The snapshot is not copied. It stays untouched until the next frame is committed,
+ *          which swaps the stores.
+ *
+ * @return const VeStore& Front store
+ */
+const VeDirectFrameHandlerBase::VeStore& VeDirectFrameHandlerBase::getSnapshot() {
+  return mStores[mFront];
+}
+
+/**
+ * @brief Copy the snapshot of the last valid frame, safe to call from another core or task
+ * @details The parser only writes to the back store. The front store can only change after
+ *          a swap, so the copy is consistent if the number of swaps did not change while
+ *          copying (a seqlock without writer side locking). Neither side ever blocks, the
+ *          copy is retried if a frame was committed in between.
+ *          veData, veEnd, getSnapshot() and newDataAvailable are not safe to use from another
+ *          core, use this function and getFrameCount() instead.
+ *
+ * @param data      Buffer for the name/value pairs
+ * @param maxLabels Size of data
+ * @param end       Number of slots copied to data
+ * @param typed     Optional buffer for the typed values
+ * @param frame     Optional number of frames committed up to this snapshot
+ * @return true     if a consistent copy was made
+ * @return false    if frames were committed during every attempt
+ */
+bool VeDirectFrameHandlerBase::readSnapshot(VeData* data, uint8_t maxLabels, int& end, VeTypedData* typed, uint32_t* frame) {
+  for (int attempt = 0; attempt < SNAPSHOT_READ_RETRIES; attempt++) {
+    uint32_t commits = mCommits.load();
+    const VeStore& store = mStores[commits & 1];
+    end = store.end < maxLabels ? store.end : maxLabels;
+    memcpy(data, store.data, end * sizeof(VeData));
+    if (typed) store.copyTyped(*typed);
+    if (frame) *frame = store.frame;
+    VeAtomicCounter::acquireFence();
+    if (mCommits.loadRelaxed() == commits) return true;
   }
+  return false;
+}
+
+/**
+ * @brief Get the number of frames committed so far, safe to call from another core or task
+ * @details Can be polled instead of isDataAvailable() to detect new frames.
+ *
+ * @return uint32_t Number of committed frames
+ */
+uint32_t VeDirectFrameHandlerBase::getFrameCount() {
+  return mCommits.load();
+}
+
+/**
+ * @brief Get the error and statistics counters
+ * @details The counters are plain integers that wrap around, take differences between two reads.
+ *
+ * @return const VeStats& Counters since the start or the last resetStats()
+ */
+const VeDirectFrameHandlerBase::VeStats& VeDirectFrameHandlerBase::getStats() {
+  return mStats;
+}
+
+/**
+ * @brief Reset all error and statistics counters to 0
+ */
+void VeDirectFrameHandlerBase::resetStats() {
+  mStats = VeStats();
 }
 
 /**
  * @brief This function is called at the end of the received frame.
- * @details If the checksum is valid, the temp buffer is read line by line.
- *          If the name exists in the public buffer, the new value is copied to the public buffer.
- *          If not, a new name/value entry is created in the public buffer.
+ * @details The records of the frame are already merged into the back store. If the checksum
+ *          is valid, the back store becomes the front store, so committing a frame does not
+ *          copy anything. In either case the slots written by the frame are remembered, to
+ *          bring the back store up to date at the start of the next frame.
+ *          With partialAccept, a frame with an invalid checksum is committed with its
+ *          plausible records, which are flagged as unverified.
  *
  * @param valid Set to true if the checksum was correct
  */
-void VeDirectFrameHandler::frameEndEvent(bool valid) {
-  if (valid) {
+void VeDirectFrameHandlerBase::frameEndEvent(bool valid) {
+  bool partial = !valid && partialAccept && frameIndex > 0 && acceptPlausible();
+  if (valid || partial) {
+    if (partial) mStats.partialFrames++;
+    else mStats.textFrames++;
     newDataAvailable = true;
-    // check if there is an existing entry
-    for (int i = 0; i < frameIndex; i++) {                  // read each name already in the temp buffer
-      bool nameExists = false;
-      for (int j = 0; j <= veEnd; j++) {                    // compare to existing names in the public buffer
-        if (strcmp(tempData[i].veName, veData[j].veName) == 0) {
-          strcpy(veData[j].veValue, tempData[i].veValue);   // overwrite tempValue in the public buffer
-          nameExists = true;
-          break;
-        }
-      }
-      if (!nameExists) {
-        strcpy(veData[veEnd].veName, tempData[i].veName);   // write new Name to public buffer
-        strcpy(veData[veEnd].veValue, tempData[i].veValue); // write new Value to public buffer
-        veEnd++;                                            // increment end of public buffer
-        if (veEnd >= buffLen) veEnd = buffLen - 1;          // stop any buffer overrun
+    if (frameIndex > 0) {                                   // back store holds the new frame
+      uint32_t* unverified = mStores[mFront ^ 1].unverified;
+      for (int i = 0; i < mWords; i++) unverified[i] = partial ? unverified[i] | mTouched[i] : unverified[i] & ~mTouched[i];
+      mFront ^= 1;
+      mStores[mFront].frame++;
+      veData = mStores[mFront].data;
+      veEnd = mStores[mFront].end;
+      // publish the new front store, the fence keeps later writes to the old one behind it
+      mCommits.store(mCommits.loadRelaxed() + 1);
+      VeAtomicCounter::releaseFence();
+#ifdef VEDIRECT_METRICS
+      if (mClock) {
+        uint32_t now = mClock();
+        mMetrics.lastLatency = now - mFrameStart;
+        if (mMetrics.lastLatency > mMetrics.maxLatency) mMetrics.maxLatency = mMetrics.lastLatency;
+        if (mMetrics.frames && now - mMetrics.lastCommit > mMetrics.longestGap) mMetrics.longestGap = now - mMetrics.lastCommit;
+        mMetrics.lastCommit = now;
+        mMetrics.frames++;
       }
+#endif
+      textCallbacks();
     }
   }
+  for (int i = 0; i < mWords; i++) {
+    mStale[i] |= mTouched[i];
+    mTouched[i] = 0;
+    mPlausible[i] = 0;
+  }
   frameIndex = 0;    // reset frame
+#ifdef VEDIRECT_METRICS
+  mFrameOpen = false;
+#endif
 }
 
 /**
- * @brief Verify that the HEX value is vaild
- *
- * @param buffer
- * @param size
- * @return true
- * @return false
+ * @brief Call the label callbacks of changed values and the frame callbacks
+ * @details Called right after a swap. The back store still holds the previous frame, so only
+ *          the slots written by this frame have to be compared to find the changed values.
+ *          With a publisher, its policies select the slots instead.
  */
-static bool hexIsValid(const char* buffer, int size) {
-  uint8_t checksum = 0x55 - ascii2hex(buffer[1]);
-  for (int i=2; i<size; i+=2) checksum -= hex2byte(buffer+i);
-  return (checksum == 0);
+void VeDirectFrameHandlerBase::textCallbacks() {
+  const VeStore& front = mStores[mFront];
+  const VeStore& previous = mStores[mFront ^ 1];
+  uint32_t changed[8] = { };                                // slots to pass to the label callbacks
+  if (mPublisher) {
+    mPublisher->evaluate(front, previous, mTouched, changed);
+  } else if (mLabelCallBacks.size()) {
+    for (int j = 0; j < mWords; j++) {
+      for (uint32_t bits = mTouched[j]; bits; bits &= bits - 1) {
+        int slot = j * 32 + __builtin_ctz(bits);
+        if (slot < previous.end && strcmp(front.data[slot].veValue, previous.data[slot].veValue) == 0) continue;
+        changed[j] |= 1u << (slot % 32);
+      }
+    }
+  }
+  mLabelCallBacks.forEach([&](VeLabelCB& cb) {
+    if (cb.name[0] == 0) {                                  // watch all labels
+      for (int j = 0; j < mWords; j++) {
+        for (uint32_t bits = changed[j]; bits; bits &= bits - 1) {
+          int slot = j * 32 + __builtin_ctz(bits);
+          cb.cbFunction(front.data[slot].veName, front.data[slot].veValue);
+        }
+      }
+      return;
+    }
+    if (cb.slot < 0) cb.slot = indexLabel(mStores[mFront], cb.name, veLabelHash(cb.name), false);
+    if (cb.slot < 0 || !(changed[cb.slot / 32] & (1u << (cb.slot % 32)))) return;
+    cb.cbFunction(cb.name, front.data[cb.slot].veValue);
+  });
+  mFrameCallBacks.forEach([&](frameFunction& cb) { cb(*this); });
 }
 
 /**
  * @brief This function records hex answers or async messages
+ * @details A complete frame is decoded once into veHexMessage, then the raw callbacks and the
+ *          matching message callbacks are called.
  *
  * @param inbyte
  * @return mState
  */
-int VeDirectFrameHandler::hexRxEvent(uint8_t inbyte) {
+int VeDirectFrameHandlerBase::hexRxEvent(uint8_t inbyte) {
   int ret = RECORD_HEX; // default - continue recording until end of frame
   switch (inbyte) {
     case '\n':
-      // message ready - call all callbacks
-      if (hexIsValid(veHexBuffer, veHEnd)) {
-        for(int i=0; i<numRegisteredCbFunctions; i++) {
-          (*(veHexCallBacks[i].cbFunction))(veHexBuffer, veHEnd, veHexCallBacks[i].cbAdditionalData);
+      // message ready - call all callbacks, or queue it for pollHex
+      if (veHexDecode(veHexBuffer, veHEnd, veHexMessage)) {
+        mStats.hexFrames++;
+        if (!mHexQueue) hexCallbacks(veHexBuffer, veHEnd, veHexMessage);
+        else if (!mHexQueue->push(veHexMessage, veHexBuffer, veHEnd)) {
+          mStats.hexQueueDrops++;
+          VE_LOG("[HEX] Queue full, message dropped", veHexMessage.reg);
         }
-      } else printf("[CHECKSUM] Invalid hex frame \n");
+      } else {
+        mStats.hexChecksumErrors++;
+        VE_LOG("[CHECKSUM] Invalid hex frame", veHEnd);
+      }
       // restore previous state
       ret = veLastTextState;
       break;
     default:
       veHexBuffer[veHEnd++] = inbyte;
-      if (veHEnd >= hexBuffLen) { // oops -buffer overflow - something went wrong, we abort
-      printf("hexRx buffer overflow - aborting read");
+      if (veHEnd >= mHexLen) { // oops -buffer overflow - something went wrong, we abort
+      mStats.hexOverflows++;
+      mStats.resyncs++;
+      VE_LOG("[HEX] Buffer overflow - aborting read", veHEnd);
       veHEnd = 0;
       ret = IDLE;
     }
@@ -275,28 +978,269 @@ int VeDirectFrameHandler::hexRxEvent(uint8_t inbyte) {
   return ret;
 }
 
+/**
+ * @brief Call the raw and the matching message callbacks of a HEX frame
+ *
+ * @param frame     Frame as received
+ * @param len       Number of chars in frame
+ * @param message   Decoded frame
+ */
+void VeDirectFrameHandlerBase::hexCallbacks(const char* frame, int len, const VeHexMessage& message) {
+  mHexCallBacks.forEach([&](hexFunction& cb) { cb(frame, len); });
+  mHexMessageCallBacks.forEach([&](VeHexMessageCB& cb) {
+    if (cb.response != VE_HEX_ANY && cb.response != message.response) return;
+    if (cb.reg != VE_HEX_ANY_REGISTER && cb.reg != message.reg) return;
+    cb.cbFunction(message);
+  });
+}
+
+/**
+ * @brief Queue the received HEX messages instead of calling the callbacks inside rxData
+ * @details rxData then only decodes and queues a HEX frame, so a slow callback can't stall
+ *          the parser. The callbacks are called by pollHex(), e.g. from another task.
+ *          Set the queue before the first rxData, it must outlive the handler.
+ *
+ * @param queue     Queue to use, nullptr to call the callbacks from rxData again
+ */
+void VeDirectFrameHandlerBase::setHexQueue(VeHexQueue* queue) {
+  mHexQueue = queue;
+}
+
+/**
+ * @brief Call the HEX callbacks of the queued messages, in the order they were received
+ * @details Call it from one task only, it may run in parallel to rxData.
+ *
+ * @param max   Maximum number of messages to process, -1 for all
+ * @return int  Number of processed messages
+ */
+int VeDirectFrameHandlerBase::pollHex(int max) {
+  int count = 0;
+  if (!mHexQueue) return count;
+  for (const VeHexQueue::Entry* entry; (max < 0 || count < max) && (entry = mHexQueue->front()) != nullptr; count++) {
+    hexCallbacks(entry->frame, entry->len, entry->message);
+    mHexQueue->pop();
+  }
+  return count;
+}
+
 /**
  * @brief This function allows you to call a function whenever a new full frame was received
+ * @details The callbacks are kept in the fixed slots of the handler (see VeCallbackCapacity),
+ *          register and remove them from the task that calls rxData (or pollHex if a queue is set).
+ *          Up to 0.20 this returned the number of registered callbacks and never failed. It now
+ *          returns a handle, which is > 0 like the old count, so "if (addHexCallback(...))" still
+ *          tests for success, but only "< 0" detects a full registry.
  *
  * @param cbFunction
  * @param cbAdditionalData
+ * @return int Handle (> 0) for removeHexCallback or -1 if all hex slots are used
+ */
+int VeDirectFrameHandlerBase::addHexCallback(hexCallback cbFunction, void* cbAdditionalData) {
+  return addHexCallback(hexFunction(cbFunction, cbAdditionalData));
+}
+
+/**
+ * @brief Same as above, with a function or a reference to a callable object (e.g. a lambda)
+ * @details The callable is not copied, it must outlive the registration.
+ *
+ * @param cbFunction  Called with the frame and its length
+ * @return int Handle (> 0) for removeHexCallback or -1 if all hex slots are used
+ */
+int VeDirectFrameHandlerBase::addHexCallback(hexFunction cbFunction) {
+  return mHexCallBacks.add(cbFunction);
+}
+
+/**
+ * @brief Remove a callback registered with addHexCallback
+ *
+ * @param handle  Result of addHexCallback
+ * @return true   if the callback was removed
+ * @return false  if the handle is invalid or was already removed
  */
-int VeDirectFrameHandler::addHexCallback(hexCallback cbFunction, void* cbAdditionalData) {
-  if (veHexCallBacks == 0) {
-    // first time, allocate callbacks buffer
-    veHexCallBacks = new VeHexCB[reservedSizeCB];
-    numRegisteredCbFunctions = 0;
-  } else if (numRegisteredCbFunctions == reservedSizeCB) { 
-    // We reached the current reserved size, no space left to store this CB
-    // so we double the reserved size and copy old data to the new list
-    int newReservedSizeCB = reservedSizeCB * 2;
-    VeHexCB* tmpHexCallBacks = new VeHexCB[newReservedSizeCB];
-    memcpy(tmpHexCallBacks, veHexCallBacks, reservedSizeCB*sizeof(VeHexCB));
-    reservedSizeCB = newReservedSizeCB;
-    delete veHexCallBacks;
-    veHexCallBacks = tmpHexCallBacks;
+bool VeDirectFrameHandlerBase::removeHexCallback(int handle) {
+  return mHexCallBacks.remove(handle);
+}
+
+/**
+ * @brief This function allows you to call a function for decoded hex messages
+ * @details Use it instead of addHexCallback to get the message already decoded, optionally only
+ *          for one response type and/or register, e.g. VE_HEX_ASYNC and 0xEDBB for the panel voltage.
+ *
+ * @param response  Response to match, see VeHexResponse, or VE_HEX_ANY
+ * @param reg       Register id to match or VE_HEX_ANY_REGISTER
+ * @param cbFunction
+ * @param cbAdditionalData
+ * @return int Handle (> 0) for removeHexMessageCallback or -1 if all hex message slots are used
+ */
+int VeDirectFrameHandlerBase::addHexMessageCallback(uint8_t response, uint16_t reg, hexMessageCallback cbFunction, void* cbAdditionalData) {
+  return addHexMessageCallback(response, reg, hexMessageFunction(cbFunction, cbAdditionalData));
+}
+
+/**
+ * @brief Same as above, with a function or a reference to a callable object (e.g. a lambda)
+ * @details The callable is not copied, it must outlive the registration.
+ *
+ * @param response    Response to match, see VeHexResponse, or VE_HEX_ANY
+ * @param reg         Register id to match or VE_HEX_ANY_REGISTER
+ * @param cbFunction  Called with the decoded message
+ * @return int Handle (> 0) for removeHexMessageCallback or -1 if all hex message slots are used
+ */
+int VeDirectFrameHandlerBase::addHexMessageCallback(uint8_t response, uint16_t reg, hexMessageFunction cbFunction) {
+  VeHexMessageCB cb = { response, reg, cbFunction };
+  return mHexMessageCallBacks.add(cb);
+}
+
+/**
+ * @brief Remove a callback registered with addHexMessageCallback
+ *
+ * @param handle  Result of addHexMessageCallback
+ * @return true   if the callback was removed
+ * @return false  if the handle is invalid or was already removed
+ */
+bool VeDirectFrameHandlerBase::removeHexMessageCallback(int handle) {
+  return mHexMessageCallBacks.remove(handle);
+}
+
+/**
+ * @brief This function allows you to call a function whenever a valid TEXT frame was received
+ * @details The callback is called from rxData after the frame was committed, veData already
+ *          holds the new values.
+ *
+ * @param cbFunction
+ * @param cbAdditionalData
+ * @return int Handle (> 0) for removeFrameCallback or -1 if all frame slots are used
+ */
+int VeDirectFrameHandlerBase::addFrameCallback(frameCallback cbFunction, void* cbAdditionalData) {
+  return addFrameCallback(frameFunction(cbFunction, cbAdditionalData));
+}
+
+/**
+ * @brief Same as above, with a function or a reference to a callable object (e.g. a lambda)
+ * @details The callable is not copied, it must outlive the registration.
+ *
+ * @param cbFunction  Called with the handler
+ * @return int Handle (> 0) for removeFrameCallback or -1 if all frame slots are used
+ */
+int VeDirectFrameHandlerBase::addFrameCallback(frameFunction cbFunction) {
+  return mFrameCallBacks.add(cbFunction);
+}
+
+/**
+ * @brief Remove a callback registered with addFrameCallback
+ *
+ * @param handle  Result of addFrameCallback
+ * @return true   if the callback was removed
+ * @return false  if the handle is invalid or was already removed
+ */
+bool VeDirectFrameHandlerBase::removeFrameCallback(int handle) {
+  return mFrameCallBacks.remove(handle);
+}
+
+/**
+ * @brief This function allows you to call a function whenever the value of a label changed
+ * @details The callback is called from rxData after the frame was committed, with the name and
+ *          the new value. Labels received with the same value as in the previous frame are skipped.
+ *
+ * @param name      Name of the label (upper case, as received) or nullptr for all labels
+ * @param cbFunction
+ * @param cbAdditionalData
+ * @return int Handle (> 0) for removeLabelCallback or -1 if all label slots are used
+ */
+int VeDirectFrameHandlerBase::addLabelCallback(const char* name, labelCallback cbFunction, void* cbAdditionalData) {
+  return addLabelCallback(name, labelFunction(cbFunction, cbAdditionalData));
+}
+
+/**
+ * @brief Same as above, with a function or a reference to a callable object (e.g. a lambda)
+ * @details The callable is not copied, it must outlive the registration.
+ *
+ * @param name        Name of the label (upper case, as received) or nullptr for all labels
+ * @param cbFunction  Called with the name and the new value
+ * @return int Handle (> 0) for removeLabelCallback or -1 if all label slots are used
+ */
+int VeDirectFrameHandlerBase::addLabelCallback(const char* name, labelFunction cbFunction) {
+  VeLabelCB cb = { };
+  strncpy(cb.name, name ? name : "", sizeof(cb.name) - 1);
+  cb.slot = -1;
+  cb.cbFunction = cbFunction;
+  return mLabelCallBacks.add(cb);
+}
+
+/**
+ * @brief Remove a callback registered with addLabelCallback
+ *
+ * @param handle  Result of addLabelCallback
+ * @return true   if the callback was removed
+ * @return false  if the handle is invalid or was already removed
+ */
+bool VeDirectFrameHandlerBase::removeLabelCallback(int handle) {
+  return mLabelCallBacks.remove(handle);
+}
+
+/**
+ * @brief Filter the values passed to the label callbacks by publish policies
+ * @details The publisher is evaluated at every committed frame, its getMask() then selects the
+ *          published labels for the serializers.
+ *
+ * @param publisher Policies to use, nullptr to call the label callbacks on every change again
+ */
+void VeDirectFrameHandlerBase::setPublisher(VePublisher* publisher) {
+  mPublisher = publisher;
+}
+
+#ifdef VEDIRECT_LOG
+/**
+ * @brief Set a function that receives the log messages of the parser
+ * @details Only available if the library is compiled with VEDIRECT_LOG. Called from rxData with
+ *          a constant message and a related value, e.g. the wrong checksum.
+ *
+ * @param cbFunction        Log function or nullptr to stop logging
+ * @param cbAdditionalData
+ */
+void VeDirectFrameHandlerBase::setLogCallback(logCallback cbFunction, void* cbAdditionalData) {
+  mLogCallBack = cbFunction;
+  mLogData = cbAdditionalData;
+}
+#endif
+
+#ifdef VEDIRECT_METRICS
+/**
+ * @brief Set the clock of the metrics and start the measurement
+ * @details Only available if the library is compiled with VEDIRECT_METRICS. The clock is read
+ *          at the first byte and at the commit of each frame, e.g. micros on Arduino.
+ *
+ * @param clock           Time source or nullptr to stop measuring
+ * @param ticksPerSecond  Resolution of the clock, e.g. 1000000 for micros
+ */
+void VeDirectFrameHandlerBase::setMetricsClock(veClockFunction clock, uint32_t ticksPerSecond) {
+  mClock = clock;
+  mTicksPerSecond = ticksPerSecond ? ticksPerSecond : 1;
+  resetMetrics();
+}
+
+/**
+ * @brief Get the metrics measured since setMetricsClock() or resetMetrics()
+ *
+ * @return VeMetrics Times and rates
+ */
+VeDirectFrameHandlerBase::VeMetrics VeDirectFrameHandlerBase::getMetrics() {
+  VeMetrics metrics = mMetrics;
+  uint32_t elapsed = mClock ? mClock() - mMetricsStart : 0;
+  if (elapsed) {
+    float seconds = (float)elapsed / mTicksPerSecond;
+    metrics.bytesPerSecond = (mStats.bytes - mMetricsBytes) / seconds;
+    metrics.framesPerSecond = metrics.frames / seconds;
   }
-  veHexCallBacks[numRegisteredCbFunctions].cbFunction = cbFunction;
-  veHexCallBacks[numRegisteredCbFunctions].cbAdditionalData = cbAdditionalData;
-  return ++numRegisteredCbFunctions;
+  return metrics;
 }
+
+/**
+ * @brief Start a new measurement
+ */
+void VeDirectFrameHandlerBase::resetMetrics() {
+  mMetrics = VeMetrics();
+  mMetricsStart = mClock ? mClock() : 0;
+  mMetricsBytes = mStats.bytes;
+  mFrameOpen = false;
+}
+#endif
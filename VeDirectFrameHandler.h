@@ -7,47 +7,232 @@
  * 2021.02.23 - 0.3 - change frameLen to 22 per VE.Direct Protocol version 3.30
  * 2022.05.16 - 0.4 - drop arduino requirements, by Martin Verges
  * 2022.05.17 - 0.5 - add support for the HEX protocol
+ * 2026.10.14 - 0.6 - add bulk rxData for buffer ingestion
+ * 2026.10.14 - 0.7 - hash index for the label lookup
+ * 2026.10.14 - 0.8 - typed store of the parsed values
+ * 2026.10.14 - 0.9 - compile-time sizing of the buffers, direct mode without tempData
+ * 2026.10.14 - 0.10 - double-buffered snapshots, commit by swapping
+ * 2026.10.14 - 0.11 - lock-free snapshot reads from another core or task
+ * 2026.10.14 - 0.12 - frame and label change callbacks for TEXT frames
+ * 2026.10.14 - 0.13 - decode HEX frames once, callbacks per response and register
+ * 2026.10.14 - 0.14 - error and statistics counters instead of printf, optional log callback
+ * 2026.10.14 - 0.15 - optional latency and throughput metrics
+ * 2026.10.14 - 0.16 - constexpr table-driven bulk parser, selected by VEDIRECT_TABLE_PARSER
+ * 2026.10.14 - 0.17 - intern the label names to label ids while receiving them
+ * 2026.10.14 - 0.18 - resync mode, reject malformed records and restart frames at PID
+ * 2026.10.14 - 0.19 - partial acceptance of the plausible records of frames with an invalid checksum
+ * 2026.10.14 - 0.20 - optional queue of HEX messages, callbacks called by pollHex
+ * 2026.10.14 - 0.21 - fixed capacity callback registry with removal and callable references
+ * 2026.10.14 - 0.22 - optional publish policies filtering the label callbacks
+ * 2026.10.14 - 0.23 - partial frames never add labels
+ * 2026.10.14 - 0.24 - typed values per slot, sized by MaxLabels
+ * 2026.10.14 - 0.25 - callback capacities as template parameter, handles are always > 0
+ * 2026.10.14 - 0.26 - slot bitsets sized by MaxLabels, shared label slots, no <atomic> on AVR
  */
 
 #ifndef FRAMEHANDLER_H_
 #define FRAMEHANDLER_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include "VeDirectCallbacks.h"
+#include "VeDirectHex.h"
+#include "VeDirectLabels.h"
+#include "VeDirectPlatform.h"
+
 const uint8_t frameLen = 22;        // VE.Direct Protocol: max frame size is 18
 const uint8_t nameLen = 9;          // VE.Direct Protocol: max name size is 9 including /0
 const uint8_t valueLen = 33;        // VE.Direct Protocol: max value size is 33 including /0
 const uint8_t buffLen = 40;         // Maximum number of lines possible from the device. Current protocol shows this to be the BMV700 at 33 lines.
 const uint8_t hexBuffLen = 100;	    // Maximum size of hex frame - max payload 34 byte (=68 char) + safe buffer
 
+#ifndef VEDIRECT_MAX_HEX_CALLBACKS
+#define VEDIRECT_MAX_HEX_CALLBACKS 1        // Default number of raw hex callbacks (max 32), see VeCallbackCapacity
+#endif
+#ifndef VEDIRECT_MAX_FRAME_CALLBACKS
+#define VEDIRECT_MAX_FRAME_CALLBACKS 2      // Default number of frame callbacks (max 32), see VeCallbackCapacity
+#endif
+#ifndef VEDIRECT_MAX_HEX_MESSAGE_CALLBACKS
+#define VEDIRECT_MAX_HEX_MESSAGE_CALLBACKS 1 // Default number of hex message callbacks (max 32), see VeCallbackCapacity
+#endif
+#ifndef VEDIRECT_MAX_LABEL_CALLBACKS
+#define VEDIRECT_MAX_LABEL_CALLBACKS 1      // Default number of label callbacks (max 32), see VeCallbackCapacity
+#endif
+
+/**
+ * @brief Number of callbacks of each kind kept by a VeDirectFrameHandlerT
+ * @details The slots are part of the handler, so unused capacity costs memory in every instance.
+ *          The defines only set the defaults and may differ between library and application.
+ */
+template <int Hex = VEDIRECT_MAX_HEX_CALLBACKS, int HexMessage = VEDIRECT_MAX_HEX_MESSAGE_CALLBACKS,
+          int Frame = VEDIRECT_MAX_FRAME_CALLBACKS, int Label = VEDIRECT_MAX_LABEL_CALLBACKS>
+struct VeCallbackCapacity {
+  static constexpr int hex = Hex;
+  static constexpr int hexMessage = HexMessage;
+  static constexpr int frame = Frame;
+  static constexpr int label = Label;
+};
+
+class VeDirectFrameHandlerBase;
+class VePublisher;
+
 typedef void (*hexCallback)(const char*, int, void*);
+typedef void (*frameCallback)(VeDirectFrameHandlerBase&, void*);
+typedef void (*labelCallback)(const char*, const char*, void*);
+typedef VeCallback<void(const char*, int)> hexFunction;
+typedef VeCallback<void(const VeHexMessage&)> hexMessageFunction;
+typedef VeCallback<void(VeDirectFrameHandlerBase&)> frameFunction;
+typedef VeCallback<void(const char*, const char*)> labelFunction;
+typedef uint32_t (*veClockFunction)();
+#ifdef VEDIRECT_LOG                         // must be the same for library and application
+typedef void (*logCallback)(const char*, int, void*);
+#endif
 
-class VeDirectFrameHandler {
+/**
+ * @brief Parser and store of a single VE.Direct port
+ * @details Holds the whole logic, the buffers are provided by VeDirectFrameHandlerT
+ *          which sizes them at compile time. Use VeDirectFrameHandlerBase& to pass
+ *          handlers of different sizes to common code.
+ */
+class VeDirectFrameHandlerBase {
   public:
-    VeDirectFrameHandler();
-    virtual ~VeDirectFrameHandler();
+    virtual ~VeDirectFrameHandlerBase();
 
     void rxData(uint8_t inbyte);
-    int addHexCallback(hexCallback cbFunction, void* cbAdditionalData);
+    void rxData(const uint8_t* buffer, size_t len);
+    int addHexCallback(hexCallback cbFunction, void* cbAdditionalData); // handle > 0, -1 if full
+    int addHexCallback(hexFunction cbFunction);
+    bool removeHexCallback(int handle);
+    int addHexMessageCallback(uint8_t response, uint16_t reg, hexMessageCallback cbFunction, void* cbAdditionalData);
+    int addHexMessageCallback(uint8_t response, uint16_t reg, hexMessageFunction cbFunction);
+    bool removeHexMessageCallback(int handle);
+    void setHexQueue(VeHexQueue* queue);
+    int pollHex(int max = -1);
+    int addFrameCallback(frameCallback cbFunction, void* cbAdditionalData);
+    int addFrameCallback(frameFunction cbFunction);
+    bool removeFrameCallback(int handle);
+    int addLabelCallback(const char* name, labelCallback cbFunction, void* cbAdditionalData);
+    int addLabelCallback(const char* name, labelFunction cbFunction);
+    bool removeLabelCallback(int handle);
+    void setPublisher(VePublisher* publisher);
     bool isDataAvailable();
     void clearData();
-    
+    int findLabel(const char* name);
+    const char* getValue(const char* name);
+    bool getTyped(VeLabel label, int32_t& value);
+    bool isVerified(int slot);
+
     struct VeData {
       char veName[nameLen];
       char veValue[valueLen];
     };
-    VeData veData[buffLen] = { };               // public buffer for received text frames
+    VeData* veData;                             // public buffer for received text frames
     bool newDataAvailable = false;              // will be set to true after receiving a frame 
 
+    struct VeTypedData {                        // typed values by label, the layout of copies (readSnapshot)
+      int32_t value[VE_LABEL_COUNT];            // parsed value of each known label, unit see VeLabel
+      uint32_t valid[(VE_LABEL_COUNT + 31) / 32]; // bit set if the label was received with a parsable value
+    };
+
+    struct VeStore {                            // one snapshot of the public store
+      VeData* data;                             // received name/value pairs
+      uint8_t* slotLabel;                       // label id of each slot in data
+      uint8_t* labelIndex;                      // open addressing index into data, slot+1 or 0 if unused
+      int32_t* typedValue;                      // parsed value of each slot, unit see VeLabel
+      uint8_t* labelSlot;                       // slot+1 of each known label, shared by both stores, use slotOf()
+      uint32_t* typedValid;                     // bit set if the slot holds a known label with a parsable value
+      uint32_t* unverified;                     // bit set if the slot was accepted from a frame with an invalid checksum
+      int end;                                  // number of used slots
+      uint32_t frame;                           // number of frames committed up to this snapshot
+
+      int slotOf(uint8_t label) const {         // slot of a known label or -1 if not in this store
+        if (label >= VE_LABEL_COUNT) return -1;
+        int slot = labelSlot[label] - 1;
+        return slot >= 0 && slot < end && slotLabel[slot] == label ? slot : -1;
+      }
+      bool isTyped(int slot) const { return slot >= 0 && (typedValid[slot / 32] & (1u << (slot % 32))); }
+      bool getTyped(uint8_t label, int32_t& value) const {
+        int slot = slotOf(label);
+        if (!isTyped(slot)) return false;
+        value = typedValue[slot];
+        return true;
+      }
+      void copyTyped(VeTypedData& typed) const;
+    };
+    const VeStore& getSnapshot();
+    bool readSnapshot(VeData* data, uint8_t maxLabels, int& end, VeTypedData* typed = nullptr, uint32_t* frame = nullptr);
+    uint32_t getFrameCount();
+
+    struct VeStats {                            // error and statistics counters
+      uint32_t bytes;                           // bytes passed to rxData
+      uint32_t textFrames;                      // TEXT frames accepted
+      uint32_t textChecksumErrors;              // TEXT frames with an invalid checksum
+      uint32_t partialFrames;                   // TEXT frames with an invalid checksum, committed with their plausible records
+      uint32_t hexFrames;                       // HEX frames decoded
+      uint32_t hexChecksumErrors;               // HEX frames that could not be decoded
+      uint32_t hexOverflows;                    // HEX frames longer than the hex buffer
+      uint32_t hexQueueDrops;                   // HEX messages dropped, the queue of setHexQueue was full
+      uint32_t nameTruncations;                 // names cut to nameLen - 1 chars
+      uint32_t valueTruncations;                // values cut to valueLen - 1 chars
+      uint32_t droppedRecords;                  // records beyond MaxFrameLines or MaxLabels
+      uint32_t resyncs;                         // times the parser dropped data and waited for the next line or frame
+    };
+    const VeStats& getStats();
+    void resetStats();
+#ifdef VEDIRECT_LOG
+    void setLogCallback(logCallback cbFunction, void* cbAdditionalData);
+#endif
+
+#ifdef VEDIRECT_METRICS                     // must be the same for library and application
+    struct VeMetrics {                          // times in ticks of the metrics clock
+      uint32_t lastLatency;                     // first byte to commit of the last valid frame
+      uint32_t maxLatency;                      // longest first byte to commit time
+      uint32_t longestGap;                      // longest time between two valid frames
+      uint32_t lastCommit;                      // clock at the last valid frame
+      uint32_t frames;                          // valid frames since the start of the measurement
+      float bytesPerSecond;                     // since the start of the measurement
+      float framesPerSecond;                    // since the start of the measurement
+    };
+    void setMetricsClock(veClockFunction clock, uint32_t ticksPerSecond);
+    VeMetrics getMetrics();
+    void resetMetrics();
+#endif
+
     // VE HEX Protocol
-    char veHexBuffer[hexBuffLen] = { };         // public buffer for received hex frames
-    struct VeHexCB {
-      hexCallback cbFunction;                   // function to call on each received hex frame
-      void* cbAdditionalData;                   // optional additional data send to CB function
+    char* veHexBuffer;                          // public buffer for received hex frames
+    VeHexMessage veHexMessage = { };           // last valid hex frame, decoded
+    struct VeHexMessageCB {
+      uint8_t response;                         // response to match, VE_HEX_ANY for all
+      uint16_t reg;                             // register to match, VE_HEX_ANY_REGISTER for all
+      hexMessageFunction cbFunction;            // function to call on matching hex messages
+    };
+    struct VeLabelCB {
+      char name[nameLen];                       // label to watch, empty for all labels
+      int slot;                                 // slot of the label in veData, -1 until received
+      labelFunction cbFunction;                 // function to call when the value changed
+    };
+    struct VeCallbackSlots {                    // callback slots provided by VeDirectFrameHandlerT
+      VeCallbackSlot<hexFunction>* hex;
+      VeCallbackSlot<VeHexMessageCB>* hexMessage;
+      VeCallbackSlot<frameFunction>* frame;
+      VeCallbackSlot<VeLabelCB>* label;
+      uint8_t hexCapacity, hexMessageCapacity, frameCapacity, labelCapacity;
     };
     int frameIndex = 0;                         // which line of the frame are we on
     int veEnd = 0;                              // current size (end) of the public buffer
     int veHEnd = 0;                             // size of hex buffer
 
     bool ignoreCheckSum = false;                // Disable checksum verification
+    bool resync = false;                        // Reject malformed records at once and restart frames at PID or a repeated label
+    bool partialAccept = false;                 // Commit the plausible records of frames with an invalid checksum as unverified
+
+  protected:
+    VeDirectFrameHandlerBase(VeStore* stores, uint8_t maxLabels, uint16_t indexLen,
+                             uint8_t maxFrameLines, char* hexBuffer, int hexLen,
+                             uint32_t* frameBits, const VeCallbackSlots& callbacks);
+    VeDirectFrameHandlerBase(const VeDirectFrameHandlerBase&) = delete;
+    VeDirectFrameHandlerBase& operator=(const VeDirectFrameHandlerBase&) = delete;
 
   private:
     enum States {                               // state machine
@@ -61,22 +246,161 @@ class VeDirectFrameHandler {
 
     int mState = States::IDLE;                  // current state
     uint8_t mChecksum = 0;                      // checksum value
-    char * mTextPointer;                        // pointer to the private buffer we're writing to, name or value
+    char * mTextPointer = nullptr;              // pointer to the private buffer we're writing to, name or value
+    bool mTruncated = false;                    // the current name or value did not fit
+    uint32_t mNameHash = 0;                     // veLabelHash of the name received so far
+    uint8_t mLabel = VE_LABEL_UNKNOWN;          // label id of the current record
+    uint8_t mLineStart = 0;                     // checksum before the \r\n of the current record
+    VeStats mStats = { };                       // error and statistics counters
+#ifdef VEDIRECT_LOG
+    logCallback mLogCallBack = nullptr;         // function to call with log messages
+    void* mLogData = nullptr;                   // optional additional data send to log function
+#endif
+#ifdef VEDIRECT_METRICS
+    veClockFunction mClock = nullptr;           // time source of the metrics, nullptr to disable them
+    uint32_t mTicksPerSecond = 1;               // ticks of mClock per second
+    uint32_t mMetricsStart = 0;                 // clock at the start of the measurement
+    uint32_t mMetricsBytes = 0;                 // mStats.bytes at the start of the measurement
+    uint32_t mFrameStart = 0;                   // clock at the first byte of the current frame
+    bool mFrameOpen = false;                    // mFrameStart is set
+    VeMetrics mMetrics = { };                   // measured times
+#endif
 
-    VeData tempData[frameLen];                  // private buffer for received key+values
+    VeStore* mStores;                           // front store (last valid frame) and back store (frame being received)
+    uint8_t mFront = 0;                         // store visible through veData
+    VeAtomicCounter mCommits;                   // number of swaps, the lowest bit is mFront for readers on other cores
+    uint8_t mMaxLabels;                         // number of slots per store
+    uint8_t mWords;                             // number of words of each slot bitset
+    uint16_t mIndexMask;                        // size of the label index - 1
+    uint8_t mMaxFrameLines;                     // maximum number of records per frame
+    int mHexLen;                                // size of veHexBuffer
 
-    char mName[9];                              // buffer for the field name
-    char mValue[33];                            // buffer for the field value
+    char mName[nameLen];                        // buffer for the field name
+    char mValue[valueLen];                      // buffer for the field value
 
+    void rxByte(uint8_t);
+    void rxRuns(const uint8_t*, size_t);
+    void rxTable(const uint8_t*, size_t);
+    void recordBegin(uint8_t);
+    void recordNameEnd();
+    void recordValueEnd();
+    void checksumEvent();
+    void rejectFrame();
+    void restartFrame();
     void textRxEvent(char *, char *);
     void frameEndEvent(bool);
-    
+    int indexLabel(VeStore&, const char*, uint32_t, bool);
+    void syncBackStore();
+    void revertSlot(int slot);
+    bool acceptPlausible();
+
+    uint32_t* mTouched;                         // slots of the back store written by the current frame
+    uint32_t* mStale;                           // slots of the back store that differ from the front store
+    uint32_t* mPlausible;                       // slots of the current frame with a known label and a valid value (partialAccept)
+
+    void textCallbacks();
+
+    VeCallbackRegistry<hexFunction> mHexCallBacks;
+    VeCallbackRegistry<VeHexMessageCB> mHexMessageCallBacks;
+    VeCallbackRegistry<frameFunction> mFrameCallBacks;
+    VeCallbackRegistry<VeLabelCB> mLabelCallBacks;
+
     int hexRxEvent(uint8_t);
+    void hexCallbacks(const char*, int, const VeHexMessage&);
+    VeHexQueue* mHexQueue = nullptr;            // queue of received messages, nullptr to call the callbacks from rxData
+    VePublisher* mPublisher = nullptr;          // publish policies of the label callbacks, nullptr for every change
+
+    int veLastTextState = States::IDLE;         // After HEX data, the TEXT message can continue (just wtf..)
+};
+
+/**
+ * @brief Compile-time sized buffers of VeDirectFrameHandlerT
+ * @details Kept in a separate base class, so they are set up before VeDirectFrameHandlerBase
+ *          is constructed with pointers to them.
+ */
+template <uint8_t MaxLabels, uint8_t MaxFrameLines, int HexLen, typename Capacity>
+struct VeDirectFrameStorage {
+  template <typename Entry, int Len>
+  using Slots = VeCallbackSlot<Entry>[Len > 0 ? Len : 1];
+
+  // The label index is a power of two with at least 1.5 buckets per label
+  static constexpr uint16_t indexLen(uint16_t len = 1) {
+    return len >= MaxLabels + MaxLabels / 2 + 1 ? len : indexLen(len * 2);
+  }
+  static constexpr uint16_t IndexLen = indexLen();
+  static constexpr int Words = (MaxLabels + 31) / 32;     // words of a slot bitset
+
+  VeDirectFrameStorage() {
+    for (uint8_t i = 0; i < 2; i++) {
+      mStoreList[i].data = mStoreData[i];
+      mStoreList[i].slotLabel = mStoreSlotLabel[i];
+      mStoreList[i].labelIndex = mStoreIndex[i];
+      mStoreList[i].typedValue = mStoreValue[i];
+      mStoreList[i].labelSlot = mLabelSlot;
+      mStoreList[i].typedValid = mStoreBits[i][0];
+      mStoreList[i].unverified = mStoreBits[i][1];
+    }
+  }
 
-    VeHexCB* veHexCallBacks;                    // struct of registered callback functions
-    int numRegisteredCbFunctions;               // number of currently registered callback functions
-    int reservedSizeCB = 1;                     // reserved memory to store callbacks n*sizeof VeHexCB
-    int veLastTextState;                        // After HEX data, the TEXT message can continue (just wtf..)
+  VeDirectFrameHandlerBase::VeStore mStoreList[2] = { };
+  VeDirectFrameHandlerBase::VeData mStoreData[2][MaxLabels] = { };
+  uint8_t mStoreSlotLabel[2][MaxLabels] = { };
+  uint8_t mStoreIndex[2][IndexLen] = { };
+  int32_t mStoreValue[2][MaxLabels] = { };
+  uint8_t mLabelSlot[VE_LABEL_COUNT] = { };
+  uint32_t mStoreBits[2][2][Words] = { };
+  uint32_t mFrameBits[3][Words] = { };
+  char mStoreHex[HexLen] = { };
+  Slots<hexFunction, Capacity::hex> mHexSlots = { };
+  Slots<VeDirectFrameHandlerBase::VeHexMessageCB, Capacity::hexMessage> mHexMessageSlots = { };
+  Slots<frameFunction, Capacity::frame> mFrameSlots = { };
+  Slots<VeDirectFrameHandlerBase::VeLabelCB, Capacity::label> mLabelSlots = { };
+
+  VeDirectFrameHandlerBase::VeCallbackSlots callbackSlots() {
+    return { mHexSlots, mHexMessageSlots, mFrameSlots, mLabelSlots,
+             Capacity::hex, Capacity::hexMessage, Capacity::frame, Capacity::label };
+  }
+};
+
+/**
+ * @brief Frame handler with compile-time sized buffers
+ * @details MaxLabels is the number of distinct labels kept in veData, MaxFrameLines the maximum
+ *          number of records accepted per frame and HexLen the size of the HEX frame buffer.
+ *          Capacity (a VeCallbackCapacity) sets the number of callbacks of each kind.
+ *          The store is kept twice: records are parsed straight into the back store and a frame
+ *          with a valid checksum just swaps it with the front store.
+ *          Snapshot holds a copy of the front store for readSnapshot().
+ */
+template <uint8_t MaxLabels, uint8_t MaxFrameLines, int HexLen, typename Capacity = VeCallbackCapacity<>>
+class VeDirectFrameHandlerT : private VeDirectFrameStorage<MaxLabels, MaxFrameLines, HexLen, Capacity>,
+                              public VeDirectFrameHandlerBase {
+    static_assert(MaxLabels > 0 && MaxLabels < 255, "MaxLabels must be within 1..254");
+    static_assert(MaxFrameLines > 0, "MaxFrameLines must be at least 1");
+    static_assert(HexLen > 1, "HexLen is too small");
+    static_assert(Capacity::hex >= 0 && Capacity::hex <= 32 && Capacity::hexMessage >= 0 && Capacity::hexMessage <= 32 &&
+                  Capacity::frame >= 0 && Capacity::frame <= 32 && Capacity::label >= 0 && Capacity::label <= 32,
+                  "callback capacities must be within 0..32");
+
+    typedef VeDirectFrameStorage<MaxLabels, MaxFrameLines, HexLen, Capacity> Storage;
+
+  public:
+    VeDirectFrameHandlerT()
+      : Storage(), VeDirectFrameHandlerBase(Storage::mStoreList, MaxLabels, Storage::IndexLen,
+                                            MaxFrameLines, Storage::mStoreHex, HexLen,
+                                            Storage::mFrameBits[0], Storage::callbackSlots()) {}
+
+    struct Snapshot {
+      VeData data[MaxLabels];                   // received name/value pairs
+      int end;                                  // number of used slots
+      uint32_t frame;                           // number of frames committed up to this snapshot
+      VeTypedData typed;                        // parsed values of the known labels
+    };
+    bool readSnapshot(Snapshot& snapshot) {
+      return VeDirectFrameHandlerBase::readSnapshot(snapshot.data, MaxLabels, snapshot.end, &snapshot.typed, &snapshot.frame);
+    }
+    using VeDirectFrameHandlerBase::readSnapshot;
 };
 
+typedef VeDirectFrameHandlerT<buffLen, frameLen, hexBuffLen> VeDirectFrameHandler;
+
 #endif // FRAMEHANDLER_H_
@@ -0,0 +1,386 @@
+/* VeDirectHex.cpp
+ *
+ * Decoder and encoder for the VE.Direct HEX protocol.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - add command encoder and request table
+ * 2026.10.14 - 0.3 - add single producer single consumer queue of received messages
+ * 2026.10.14 - 0.4 - cancel requests of one callback
+ * 2026.10.14 - 0.5 - queue counters through VeAtomicCounter, no <atomic> on AVR
+ */
+
+#include <string.h>
+
+#include "VeDirectHex.h"
+
+/**
+ * @brief Convert a hex digit
+ *
+ * @param c     Digit, upper or lower case
+ * @return int  Value of the digit or -1 if it's not a hex digit
+ */
+static int hexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+/**
+ * @brief Decode a received HEX frame
+ * @details The frame is ":" followed by the command nibble, the payload bytes and the checksum
+ *          byte, all written as hex digits. The sum of all bytes including the checksum is 0x55.
+ *          Get, set and async messages start with the register id (little endian) and the flags,
+ *          see VeHexMessage.
+ *
+ * @param buffer  Frame as received, starting with ':' (without the terminating \n)
+ * @param size    Number of chars in buffer
+ * @param message Decoded message
+ * @return true   if the frame is well formed and the checksum is valid
+ * @return false  otherwise, message is undefined
+ */
+bool veHexDecode(const char* buffer, int size, VeHexMessage& message) {
+  if (size > 0 && buffer[size - 1] == '\r') size--;
+  if (size < 4 || buffer[0] != ':' || (size % 2) != 0) return false;
+
+  int command = hexDigit(buffer[1]);
+  if (command < 0) return false;
+  uint8_t checksum = command;
+  uint8_t bytes[hexMaxValueLen + 4];
+  int len = 0;
+  for (int i = 2; i < size; i += 2) {
+    int hi = hexDigit(buffer[i]);
+    int lo = hexDigit(buffer[i + 1]);
+    if (hi < 0 || lo < 0 || len >= (int)sizeof(bytes)) return false;
+    bytes[len] = hi * 16 + lo;
+    checksum += bytes[len++];
+  }
+  if (checksum != 0x55) return false;
+  len--;                                          // drop the checksum byte
+
+  message.response = command;
+  int start = 0;
+  if (command == VE_HEX_GET || command == VE_HEX_SET || command == VE_HEX_ASYNC) {
+    if (len < 3) return false;
+    message.reg = bytes[0] | (bytes[1] << 8);
+    message.flags = bytes[2];
+    start = 3;
+  } else {
+    message.reg = 0;
+    message.flags = 0;
+  }
+  if (len - start > hexMaxValueLen) return false;
+  message.len = len - start;
+  message.value = 0;
+  for (int i = 0; i < message.len; i++) {
+    message.data[i] = bytes[start + i];
+    if (i < 4) message.value |= (uint32_t)message.data[i] << (8 * i);
+  }
+  return true;
+}
+
+/**
+ * @brief Get the value of a message as signed number
+ *
+ * @param message  Decoded message
+ * @return int32_t Value, sign extended from the number of value bytes (up to 4)
+ */
+int32_t veHexSigned(const VeHexMessage& message) {
+  if (message.len == 0 || message.len >= 4) return (int32_t)message.value;
+  uint32_t sign = 1u << (8 * message.len - 1);
+  return (int32_t)((message.value ^ sign) - sign);
+}
+
+/**
+ * @brief Encode a HEX frame to send to the device
+ * @details Writes ":", the command nibble, the payload and the checksum as upper case hex digits,
+ *          followed by "\n" and a terminating zero. Does not allocate memory.
+ *
+ * @param buffer  Output buffer
+ * @param size    Size of buffer, 2 * len + 6 chars are needed
+ * @param command Command nibble, see VeHexCommand
+ * @param payload Payload bytes
+ * @param len     Number of payload bytes
+ * @return int    Number of chars written without the terminating zero, 0 if buffer is too small
+ */
+int veHexEncode(char* buffer, int size, uint8_t command, const uint8_t* payload, uint8_t len) {
+  static const char digits[] = "0123456789ABCDEF";
+  if (size < 2 * len + 6) return 0;
+  int pos = 0;
+  uint8_t checksum = 0x55 - (command & 0x0F);
+  buffer[pos++] = ':';
+  buffer[pos++] = digits[command & 0x0F];
+  for (int i = 0; i < len; i++) {
+    buffer[pos++] = digits[payload[i] >> 4];
+    buffer[pos++] = digits[payload[i] & 0x0F];
+    checksum -= payload[i];
+  }
+  buffer[pos++] = digits[checksum >> 4];
+  buffer[pos++] = digits[checksum & 0x0F];
+  buffer[pos++] = '\n';
+  buffer[pos] = 0;
+  return pos;
+}
+
+/**
+ * @brief Encode a ping command (":154\n")
+ *
+ * @param buffer  Output buffer
+ * @param size    Size of buffer
+ * @return int    Number of chars written, 0 if buffer is too small
+ */
+int veHexEncodePing(char* buffer, int size) {
+  return veHexEncode(buffer, size, VE_HEX_CMD_PING, nullptr, 0);
+}
+
+/**
+ * @brief Encode an app version command (":352\n")
+ *
+ * @param buffer  Output buffer
+ * @param size    Size of buffer
+ * @return int    Number of chars written, 0 if buffer is too small
+ */
+int veHexEncodeAppVersion(char* buffer, int size) {
+  return veHexEncode(buffer, size, VE_HEX_CMD_APP_VERSION, nullptr, 0);
+}
+
+/**
+ * @brief Encode a product id command (":451\n")
+ *
+ * @param buffer  Output buffer
+ * @param size    Size of buffer
+ * @return int    Number of chars written, 0 if buffer is too small
+ */
+int veHexEncodeProductId(char* buffer, int size) {
+  return veHexEncode(buffer, size, VE_HEX_CMD_PRODUCT_ID, nullptr, 0);
+}
+
+/**
+ * @brief Encode a get command, e.g. ":7F0ED0071\n" for register 0xEDF0
+ *
+ * @param buffer  Output buffer
+ * @param size    Size of buffer
+ * @param reg     Register id
+ * @return int    Number of chars written, 0 if buffer is too small
+ */
+int veHexEncodeGet(char* buffer, int size, uint16_t reg) {
+  uint8_t payload[] = { (uint8_t)reg, (uint8_t)(reg >> 8), 0 };
+  return veHexEncode(buffer, size, VE_HEX_CMD_GET, payload, sizeof(payload));
+}
+
+/**
+ * @brief Encode a set command
+ *
+ * @param buffer  Output buffer
+ * @param size    Size of buffer
+ * @param reg     Register id
+ * @param value   New value
+ * @param len     Size of the register in bytes (1 to 4)
+ * @return int    Number of chars written, 0 if buffer is too small or len is invalid
+ */
+int veHexEncodeSet(char* buffer, int size, uint16_t reg, uint32_t value, uint8_t len) {
+  if (len < 1 || len > 4) return 0;
+  uint8_t payload[7] = { (uint8_t)reg, (uint8_t)(reg >> 8), 0 };
+  for (int i = 0; i < len; i++) payload[3 + i] = (uint8_t)(value >> (8 * i));
+  return veHexEncode(buffer, size, VE_HEX_CMD_SET, payload, 3 + len);
+}
+
+/**
+ * @brief Add a request that was sent to the device
+ *
+ * @param command   Command sent, see VeHexCommand
+ * @param reg       Register id of get and set commands, ignored otherwise
+ * @param now       Current time
+ * @param timeout   Time to wait for the response
+ * @param cbFunction        Function to call with the response, or with nullptr on timeout
+ * @param cbAdditionalData  Optional additional data send to CB function
+ * @return int      Number of requests in flight or -1 if VEDIRECT_MAX_HEX_REQUESTS is reached
+ */
+int VeHexRequestTable::add(uint8_t command, uint16_t reg, uint32_t now, uint32_t timeout, hexResponseCallback cbFunction, void* cbAdditionalData) {
+  for (VeHexRequest& request : mRequests) {
+    if (request.used) continue;
+    request.used = true;
+    request.command = command;
+    request.reg = (command == VE_HEX_CMD_GET || command == VE_HEX_CMD_SET) ? reg : 0;
+    request.sequence = mSequence++;
+    request.deadline = now + timeout;
+    request.cbFunction = cbFunction;
+    request.cbAdditionalData = cbAdditionalData;
+    return pending();
+  }
+  return -1;
+}
+
+/**
+ * @brief Check if a message is a possible response to a request
+ *
+ * @param request   Request in flight
+ * @param message   Received message
+ * @return true     if the message answers the request
+ * @return false    otherwise
+ */
+bool VeHexRequestTable::answers(const VeHexRequest& request, const VeHexMessage& message) {
+  switch (message.response) {
+    case VE_HEX_GET:
+      return request.command == VE_HEX_CMD_GET && request.reg == message.reg;
+    case VE_HEX_SET:
+      return request.command == VE_HEX_CMD_SET && request.reg == message.reg;
+    case VE_HEX_PING:
+      return request.command == VE_HEX_CMD_PING;
+    case VE_HEX_DONE:
+      return request.command == VE_HEX_CMD_APP_VERSION || request.command == VE_HEX_CMD_PRODUCT_ID;
+    case VE_HEX_UNKNOWN:
+    case VE_HEX_ERROR:
+      return true;
+    default:                                          // async messages are no responses
+      return false;
+  }
+}
+
+/**
+ * @brief Remove a request and call its callback
+ *
+ * @param request   Request in flight
+ * @param message   Response or nullptr on timeout
+ */
+void VeHexRequestTable::finish(VeHexRequest& request, const VeHexMessage* message) {
+  request.used = false;
+  if (request.cbFunction) request.cbFunction(message, request.cbAdditionalData);
+}
+
+/**
+ * @brief Match a received message with the requests in flight
+ * @details The oldest request the message can answer is completed.
+ *
+ * @param message   Decoded message
+ * @return true     if the message was the response to a request
+ * @return false    if not (e.g. async messages)
+ */
+bool VeHexRequestTable::onMessage(const VeHexMessage& message) {
+  VeHexRequest* oldest = nullptr;
+  for (VeHexRequest& request : mRequests) {
+    if (!request.used || !answers(request, message)) continue;
+    if (!oldest || (int32_t)(request.sequence - oldest->sequence) < 0) oldest = &request;
+  }
+  if (!oldest) return false;
+  finish(*oldest, &message);
+  return true;
+}
+
+/**
+ * @brief Time out requests without response
+ *
+ * @param now   Current time
+ * @return int  Number of requests that timed out
+ */
+int VeHexRequestTable::expire(uint32_t now) {
+  int expired = 0;
+  for (VeHexRequest& request : mRequests) {
+    if (!request.used || (int32_t)(now - request.deadline) < 0) continue;
+    finish(request, nullptr);
+    expired++;
+  }
+  return expired;
+}
+
+/**
+ * @brief Get the number of requests in flight
+ *
+ * @return int Number of requests
+ */
+int VeHexRequestTable::pending() {
+  int count = 0;
+  for (const VeHexRequest& request : mRequests) count += request.used;
+  return count;
+}
+
+/**
+ * @brief Drop the requests of one callback without calling it, e.g. if sending the command failed
+ *
+ * @param cbAdditionalData  Additional data the requests were added with
+ * @return int              Number of requests dropped
+ */
+int VeHexRequestTable::cancel(void* cbAdditionalData) {
+  int cancelled = 0;
+  for (VeHexRequest& request : mRequests) {
+    if (!request.used || request.cbAdditionalData != cbAdditionalData) continue;
+    request.used = false;
+    cancelled++;
+  }
+  return cancelled;
+}
+
+/**
+ * @brief Drop all requests without calling their callbacks
+ */
+void VeHexRequestTable::clear() {
+  for (VeHexRequest& request : mRequests) request.used = false;
+}
+
+/**
+ * @brief Callback to register with VeDirectFrameHandler::addHexMessageCallback
+ *
+ * @param message   Decoded message
+ * @param table     VeHexRequestTable to feed
+ */
+void VeHexRequestTable::messageCallback(const VeHexMessage& message, void* table) {
+  static_cast<VeHexRequestTable*>(table)->onMessage(message);
+}
+
+/**
+ * @brief Add a message at the end of the queue, called by the producer only
+ *
+ * @param message   Decoded message
+ * @param frame     Frame as received
+ * @param len       Number of chars in frame
+ * @return true     if the message was queued
+ * @return false    if the queue is full or the frame too long, the message is dropped
+ */
+bool VeHexQueue::push(const VeHexMessage& message, const char* frame, int len) {
+  uint32_t head = mHead.loadRelaxed();
+  if (len < 0 || len > hexMaxFrameLen || head - mTail.load() > mMask) return false;
+  Entry& entry = mEntries[head & mMask];
+  entry.message = message;
+  entry.len = len;
+  memcpy(entry.frame, frame, len);
+  mHead.store(head + 1);
+  return true;
+}
+
+/**
+ * @brief Get the oldest message, called by the consumer only
+ *
+ * @return const Entry* Oldest entry, valid until pop(), or nullptr if the queue is empty
+ */
+const VeHexQueue::Entry* VeHexQueue::front() {
+  uint32_t tail = mTail.loadRelaxed();
+  if (tail == mHead.load()) return nullptr;
+  return &mEntries[tail & mMask];
+}
+
+/**
+ * @brief Release the oldest message, called by the consumer only after front() returned it
+ */
+void VeHexQueue::pop() {
+  mTail.store(mTail.loadRelaxed() + 1);
+}
+
+/**
+ * @brief Get the number of queued messages
+ *
+ * @return int Number of messages, a snapshot if the other side is active
+ */
+int VeHexQueue::size() {
+  return mHead.load() - mTail.load();
+}
+
+/**
+ * @brief Get the maximum number of queued messages
+ *
+ * @return int Capacity of the queue
+ */
+int VeHexQueue::capacity() {
+  return mMask + 1;
+}
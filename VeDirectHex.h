@@ -0,0 +1,162 @@
+/* VeDirectHex.h
+ *
+ * Decoder and encoder for the VE.Direct HEX protocol.
+ * Based on the "VE.Direct HEX protocol" document of Victron, version 5.
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - add command encoder and request table
+ * 2026.10.14 - 0.3 - add single producer single consumer queue of received messages
+ * 2026.10.14 - 0.4 - cancel requests of one callback
+ * 2026.10.14 - 0.5 - queue counters through VeAtomicCounter, no <atomic> on AVR
+ */
+
+#ifndef VEDIRECTHEX_H_
+#define VEDIRECTHEX_H_
+
+#include <stdint.h>
+
+#include "VeDirectPlatform.h"
+
+#ifndef VEDIRECT_MAX_HEX_REQUESTS
+#define VEDIRECT_MAX_HEX_REQUESTS 8         // Number of requests in flight, must be the same for library and application
+#endif
+
+const uint8_t hexMaxValueLen = 32;  // HEX Protocol: biggest value of a register, the max payload is 34 byte
+const uint8_t hexMaxFrameLen = 2 + 2 * (3 + hexMaxValueLen + 1) + 1;  // longest decodable frame: ':', command, payload, checksum, '\r'
+
+enum VeHexCommand : uint8_t {       // command nibble of messages sent to the device
+  VE_HEX_CMD_PING = 0x1,            // answered with VE_HEX_PING
+  VE_HEX_CMD_APP_VERSION = 0x3,     // answered with VE_HEX_DONE
+  VE_HEX_CMD_PRODUCT_ID = 0x4,      // answered with VE_HEX_DONE
+  VE_HEX_CMD_RESTART = 0x6,         // not answered
+  VE_HEX_CMD_GET = 0x7,             // answered with VE_HEX_GET
+  VE_HEX_CMD_SET = 0x8              // answered with VE_HEX_SET
+};
+
+enum VeHexResponse : uint8_t {      // command nibble of messages sent by the device
+  VE_HEX_DONE = 0x1,                // answer to app version and product id
+  VE_HEX_UNKNOWN = 0x3,             // unknown command
+  VE_HEX_ERROR = 0x4,               // frame error
+  VE_HEX_PING = 0x5,                // answer to ping, holds the firmware version
+  VE_HEX_GET = 0x7,                 // answer to get
+  VE_HEX_SET = 0x8,                 // answer to set
+  VE_HEX_ASYNC = 0xA,               // asynchronous register update
+  VE_HEX_ANY = 0xFF                 // wildcard for addHexMessageCallback
+};
+
+enum VeHexFlags : uint8_t {         // flags of get, set and async messages
+  VE_HEX_FLAG_UNKNOWN_ID = 0x01,
+  VE_HEX_FLAG_NOT_SUPPORTED = 0x02,
+  VE_HEX_FLAG_PARAMETER_ERROR = 0x04
+};
+
+const uint16_t VE_HEX_ANY_REGISTER = 0xFFFF;  // wildcard for addHexMessageCallback
+
+struct VeHexMessage {
+  uint8_t response;                 // command nibble, see VeHexResponse
+  uint16_t reg;                     // register id of get, set and async messages, 0 otherwise
+  uint8_t flags;                    // flags of get, set and async messages, see VeHexFlags
+  uint8_t len;                      // number of bytes in data
+  uint8_t data[hexMaxValueLen];     // value (little endian) or payload of messages without register
+  uint32_t value;                   // up to the first 4 bytes of data as unsigned number
+};
+
+typedef void (*hexMessageCallback)(const VeHexMessage&, void*);
+typedef void (*hexResponseCallback)(const VeHexMessage*, void*);
+
+bool veHexDecode(const char* buffer, int size, VeHexMessage& message);
+int32_t veHexSigned(const VeHexMessage& message);
+
+int veHexEncode(char* buffer, int size, uint8_t command, const uint8_t* payload, uint8_t len);
+int veHexEncodePing(char* buffer, int size);
+int veHexEncodeAppVersion(char* buffer, int size);
+int veHexEncodeProductId(char* buffer, int size);
+int veHexEncodeGet(char* buffer, int size, uint16_t reg);
+int veHexEncodeSet(char* buffer, int size, uint16_t reg, uint32_t value, uint8_t len);
+
+/**
+ * @brief Requests in flight, matched with the responses of the device
+ * @details Get and set responses are matched by register id, so several requests can be sent
+ *          without waiting for the answers. Other responses are matched to the oldest request
+ *          they can answer. Feed all decoded messages to onMessage(), e.g. by registering
+ *          VeHexRequestTable::messageCallback with addHexMessageCallback(VE_HEX_ANY, VE_HEX_ANY_REGISTER, ...),
+ *          and call expire() regularly. Times are in any unit (e.g. millis()) and may wrap.
+ */
+class VeHexRequestTable {
+  public:
+    int add(uint8_t command, uint16_t reg, uint32_t now, uint32_t timeout, hexResponseCallback cbFunction, void* cbAdditionalData);
+    bool onMessage(const VeHexMessage& message);
+    int expire(uint32_t now);
+    int pending();
+    int cancel(void* cbAdditionalData);
+    void clear();
+
+    static void messageCallback(const VeHexMessage& message, void* table);
+
+  private:
+    struct VeHexRequest {
+      bool used;                            // slot holds a request in flight
+      uint8_t command;                      // command sent, see VeHexCommand
+      uint16_t reg;                         // register id of get and set requests
+      uint32_t sequence;                    // order of the requests, the oldest is answered first
+      uint32_t deadline;                    // time the request times out
+      hexResponseCallback cbFunction;       // function to call with the response, or nullptr on timeout
+      void* cbAdditionalData;               // optional additional data send to CB function
+    };
+    VeHexRequest mRequests[VEDIRECT_MAX_HEX_REQUESTS] = { };
+    uint32_t mSequence = 0;                 // sequence number of the next request
+
+    bool answers(const VeHexRequest& request, const VeHexMessage& message);
+    void finish(VeHexRequest& request, const VeHexMessage* message);
+};
+
+/**
+ * @brief Bounded queue of received HEX messages, one producer and one consumer
+ * @details The frame handler pushes the decoded messages (see VeDirectFrameHandlerBase::setHexQueue),
+ *          the consumer drains them later, e.g. with pollHex() from another task. Neither side
+ *          blocks or allocates, a message is dropped if the queue is full.
+ *          The entries are read in place: front() returns the oldest, pop() releases it.
+ *          The storage is provided by VeHexQueueT.
+ */
+class VeHexQueue {
+  public:
+    struct Entry {
+      VeHexMessage message;                 // decoded message
+      uint8_t len;                          // number of chars in frame
+      char frame[hexMaxFrameLen];           // frame as received, starting with ':'
+    };
+
+    bool push(const VeHexMessage& message, const char* frame, int len);
+    const Entry* front();
+    void pop();
+    int size();
+    int capacity();
+
+  protected:
+    VeHexQueue(Entry* entries, uint32_t len) : mEntries(entries), mMask(len - 1) { }
+    VeHexQueue(const VeHexQueue&) = delete;
+    VeHexQueue& operator=(const VeHexQueue&) = delete;
+
+  private:
+    Entry* mEntries;                        // ring of len entries
+    uint32_t mMask;                         // len - 1, len is a power of 2
+    VeAtomicCounter mHead;                  // entries pushed, written by the producer only
+    VeAtomicCounter mTail;                  // entries popped, written by the consumer only
+};
+
+/**
+ * @brief Queue of HEX messages with compile-time sized storage
+ * @details Len must be a power of 2, each entry takes about 120 bytes.
+ */
+template <uint32_t Len>
+class VeHexQueueT : public VeHexQueue {
+    static_assert(Len > 0 && (Len & (Len - 1)) == 0, "Len must be a power of 2");
+
+  public:
+    VeHexQueueT() : VeHexQueue(mStorage, Len) { }
+
+  private:
+    Entry mStorage[Len] = { };
+};
+
+#endif // VEDIRECTHEX_H_
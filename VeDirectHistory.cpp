@@ -0,0 +1,311 @@
+/* VeDirectHistory.cpp
+ *
+ * Fixed memory history of one numeric label with 1 s, 1 min and 1 h resolution.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - 32 bit value count of the aggregates, the average stays exact
+ * 2026.10.14 - 0.3 - history groups recording many labels from one frame callback, detach
+ */
+
+#include "VeDirectHistory.h"
+
+/**
+ * @brief Construct a new history
+ * @details The rings are owned by the caller (see VeDirectHistoryT).
+ *
+ * @param label     Numeric label to record
+ * @param raw       Ring of raw values
+ * @param rawLen    Size of raw
+ * @param minutes   Ring of minute aggregates
+ * @param minuteLen Size of minutes
+ * @param hours     Ring of hour aggregates
+ * @param hourLen   Size of hours
+ */
+VeDirectHistoryBase::VeDirectHistoryBase(VeLabel label, VeHistoryPoint* raw, uint16_t rawLen,
+                                         VeHistorySample* minutes, uint16_t minuteLen, VeHistorySample* hours, uint16_t hourLen)
+  : mLabel(label), mRaw(raw), mMinutes(minutes), mHours(hours),
+    mRawRing{rawLen, 0, 0}, mMinuteRing{minuteLen, 0, 0}, mHourRing{hourLen, 0, 0} {}
+
+/**
+ * @brief Record the label of every valid frame of a handler
+ * @details Takes one frame callback of the handler. The handler has few of them (see
+ *          VeCallbackCapacity), check the result. Use a VeDirectHistoryGroup for several labels.
+ *
+ * @param handler Frame handler to record from
+ * @param clock   Time in seconds, e.g. a function returning millis() / 1000
+ * @return int    Handle of the frame callback (> 0), -1 if already attached, without a clock
+ *                or if the handler has no free frame callback
+ */
+int VeDirectHistoryBase::attach(VeDirectFrameHandlerBase& handler, veClockFunction clock) {
+  if (mHandler || !clock) return -1;
+  int handle = handler.addFrameCallback(frameEvent, this);
+  if (handle < 0) return -1;
+  mClock = clock;
+  mHandler = &handler;
+  mHandle = handle;
+  return handle;
+}
+
+/**
+ * @brief Stop recording, the values are kept
+ *
+ * @return true   if the frame callback was removed
+ * @return false  if the history was not attached
+ */
+bool VeDirectHistoryBase::detach() {
+  if (!mHandler) return false;
+  mHandler->removeFrameCallback(mHandle);
+  mHandler = nullptr;
+  mHandle = -1;
+  return true;
+}
+
+/**
+ * @brief Add the value of the label of a new frame
+ *
+ * @param handler Frame handler that received the frame
+ * @param history VeDirectHistoryBase to add to
+ */
+void VeDirectHistoryBase::frameEvent(VeDirectFrameHandlerBase& handler, void* history) {
+  VeDirectHistoryBase& self = *static_cast<VeDirectHistoryBase*>(history);
+  int32_t value;
+  if (handler.getTyped(self.mLabel, value)) self.add(self.mClock(), value);
+}
+
+/**
+ * @brief Add a value
+ * @details A value of the same second as the newest raw value replaces it in the raw ring, all
+ *          values count for the minute and hour aggregates.
+ *
+ * @param time  Clock in seconds
+ * @param value Typed value
+ */
+void VeDirectHistoryBase::add(uint32_t time, int32_t value) {
+  int newest = index(mRawRing, 0);
+  if (newest < 0 || mRaw[newest].time != time) newest = push(mRawRing);
+  mRaw[newest].time = time;
+  mRaw[newest].value = value;
+
+  uint32_t minute = time - time % 60;
+  if (mMinute.count && mMinute.start != minute) flush(mMinute, mMinuteRing, mMinutes);
+  accumulate(mMinute, minute, value);
+
+  uint32_t hour = time - time % 3600;
+  if (mHour.count && mHour.start != hour) flush(mHour, mHourRing, mHours);
+  accumulate(mHour, hour, value);
+}
+
+/**
+ * @brief Add a value to the aggregate of the current interval
+ */
+void VeDirectHistoryBase::accumulate(VeAccumulator& acc, uint32_t start, int32_t value) {
+  if (!acc.count) {
+    acc.start = start;
+    acc.min = acc.max = value;
+    acc.sum = 0;
+  }
+  if (value < acc.min) acc.min = value;
+  if (value > acc.max) acc.max = value;
+  if (acc.count == UINT32_MAX) return;      // sum and count stop together, the average stays right
+  acc.sum += value;
+  acc.count++;
+}
+
+/**
+ * @brief Push the aggregate of a complete interval into its ring and restart it
+ */
+void VeDirectHistoryBase::flush(VeAccumulator& acc, VeRing& ring, VeHistorySample* samples) {
+  VeHistorySample& sample = samples[push(ring)];
+  sample.time = acc.start;
+  sample.min = acc.min;
+  sample.max = acc.max;
+  sample.avg = (int32_t)(acc.sum / acc.count);
+  sample.count = acc.count < UINT16_MAX ? acc.count : UINT16_MAX;
+  acc.count = 0;
+}
+
+/**
+ * @brief Reserve the next entry of a ring, overwriting the oldest one if it is full
+ *
+ * @return uint16_t Index of the entry
+ */
+uint16_t VeDirectHistoryBase::push(VeRing& ring) {
+  uint16_t i = ring.head;
+  ring.head = (ring.head + 1) % ring.len;
+  if (ring.count < ring.len) ring.count++;
+  return i;
+}
+
+/**
+ * @brief Get the index of an entry by its age
+ *
+ * @return int Index or -1 if the ring has less entries
+ */
+int VeDirectHistoryBase::index(const VeRing& ring, int age) {
+  if (age < 0 || age >= ring.count) return -1;
+  return (ring.head + ring.len - 1 - age) % ring.len;
+}
+
+/**
+ * @brief Forget all values
+ */
+void VeDirectHistoryBase::clear() {
+  mRawRing.head = mRawRing.count = 0;
+  mMinuteRing.head = mMinuteRing.count = 0;
+  mHourRing.head = mHourRing.count = 0;
+  mMinute.count = mHour.count = 0;
+}
+
+/**
+ * @brief Get the label of the history
+ *
+ * @return VeLabel Label id
+ */
+VeLabel VeDirectHistoryBase::getLabel() {
+  return mLabel;
+}
+
+/**
+ * @brief Get the number of raw values
+ *
+ * @return int Number of values
+ */
+int VeDirectHistoryBase::getRawCount() {
+  return mRawRing.count;
+}
+
+/**
+ * @brief Get the number of complete minutes
+ *
+ * @return int Number of minute aggregates
+ */
+int VeDirectHistoryBase::getMinuteCount() {
+  return mMinuteRing.count;
+}
+
+/**
+ * @brief Get the number of complete hours
+ *
+ * @return int Number of hour aggregates
+ */
+int VeDirectHistoryBase::getHourCount() {
+  return mHourRing.count;
+}
+
+/**
+ * @brief Get a raw value
+ *
+ * @param age     0 for the newest value
+ * @param point   Time and value
+ * @return true   if the value exists
+ * @return false  if age is out of range
+ */
+bool VeDirectHistoryBase::getRaw(int age, VeHistoryPoint& point) {
+  int i = index(mRawRing, age);
+  if (i < 0) return false;
+  point = mRaw[i];
+  return true;
+}
+
+/**
+ * @brief Get the aggregate of a complete minute
+ *
+ * @param age     0 for the last complete minute
+ * @param sample  Start, min, max and average of the minute
+ * @return true   if the minute exists
+ * @return false  if age is out of range
+ */
+bool VeDirectHistoryBase::getMinute(int age, VeHistorySample& sample) {
+  int i = index(mMinuteRing, age);
+  if (i < 0) return false;
+  sample = mMinutes[i];
+  return true;
+}
+
+/**
+ * @brief Get the aggregate of a complete hour
+ *
+ * @param age     0 for the last complete hour
+ * @param sample  Start, min, max and average of the hour
+ * @return true   if the hour exists
+ * @return false  if age is out of range
+ */
+bool VeDirectHistoryBase::getHour(int age, VeHistorySample& sample) {
+  int i = index(mHourRing, age);
+  if (i < 0) return false;
+  sample = mHours[i];
+  return true;
+}
+
+/**
+ * @brief Add a history to the group
+ * @details Add all histories before attach(), a history must be in one group only.
+ *
+ * @param history History to record, not attached on its own
+ * @return true   if the history was added
+ * @return false  if VEDIRECT_HISTORY_GROUP_MAX is reached
+ */
+bool VeDirectHistoryGroup::add(VeDirectHistoryBase& history) {
+  if (mCount >= VEDIRECT_HISTORY_GROUP_MAX) return false;
+  mHistories[mCount++] = &history;
+  return true;
+}
+
+/**
+ * @brief Record the labels of all histories of the group from every valid frame of a handler
+ *
+ * @param handler Frame handler to record from
+ * @param clock   Time in seconds, e.g. a function returning millis() / 1000
+ * @return int    Handle of the frame callback (> 0), -1 if already attached, without a clock
+ *                or if the handler has no free frame callback
+ */
+int VeDirectHistoryGroup::attach(VeDirectFrameHandlerBase& handler, veClockFunction clock) {
+  if (mHandler || !clock) return -1;
+  int handle = handler.addFrameCallback(frameEvent, this);
+  if (handle < 0) return -1;
+  mClock = clock;
+  mHandler = &handler;
+  mHandle = handle;
+  return handle;
+}
+
+/**
+ * @brief Stop recording, the values are kept
+ *
+ * @return true   if the frame callback was removed
+ * @return false  if the group was not attached
+ */
+bool VeDirectHistoryGroup::detach() {
+  if (!mHandler) return false;
+  mHandler->removeFrameCallback(mHandle);
+  mHandler = nullptr;
+  mHandle = -1;
+  return true;
+}
+
+/**
+ * @brief Get the number of histories of the group
+ *
+ * @return int Number of histories
+ */
+int VeDirectHistoryGroup::size() {
+  return mCount;
+}
+
+/**
+ * @brief Add the values of the labels of a new frame, all with the same time
+ *
+ * @param handler Frame handler that received the frame
+ * @param group   VeDirectHistoryGroup to add to
+ */
+void VeDirectHistoryGroup::frameEvent(VeDirectFrameHandlerBase& handler, void* group) {
+  VeDirectHistoryGroup& self = *static_cast<VeDirectHistoryGroup*>(group);
+  uint32_t time = self.mClock();
+  for (int i = 0; i < self.mCount; i++) {
+    VeDirectHistoryBase& history = *self.mHistories[i];
+    int32_t value;
+    if (handler.getTyped(history.getLabel(), value)) history.add(time, value);
+  }
+}
@@ -0,0 +1,146 @@
+/* VeDirectHistory.h
+ *
+ * Fixed memory history of one numeric label with 1 s, 1 min and 1 h resolution.
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - 32 bit value count of the aggregates, the average stays exact
+ * 2026.10.14 - 0.3 - history groups recording many labels from one frame callback, detach
+ */
+
+#ifndef VEDIRECTHISTORY_H_
+#define VEDIRECTHISTORY_H_
+
+#include "VeDirectFrameHandler.h"
+
+#ifndef VEDIRECT_HISTORY_GROUP_MAX
+#define VEDIRECT_HISTORY_GROUP_MAX 8        // Number of histories of a group, must be the same for library and application
+#endif
+
+struct VeHistoryPoint {                       // one raw value
+  uint32_t time;                              // clock in seconds
+  int32_t value;                              // typed value, unit see VeLabel
+};
+
+struct VeHistorySample {                      // aggregate of one minute or hour
+  uint32_t time;                              // start of the interval in seconds
+  int32_t min;                                // smallest value
+  int32_t max;                                // largest value
+  int32_t avg;                                // average of the raw values
+  uint16_t count;                             // number of raw values, at most UINT16_MAX
+};
+
+/**
+ * @brief History of one label in three rings
+ * @details Every value goes into the raw ring (one per second, a later value of the same second
+ *          replaces the earlier one) and into the aggregates of the current minute and hour.
+ *          A complete minute or hour is pushed into its ring. The rings are provided by
+ *          VeDirectHistoryT which sizes them at compile time. Age 0 is the newest entry.
+ */
+class VeDirectHistoryBase {
+  public:
+    void add(uint32_t time, int32_t value);
+    int attach(VeDirectFrameHandlerBase& handler, veClockFunction clock);
+    bool detach();
+    void clear();
+
+    VeLabel getLabel();
+    int getRawCount();
+    int getMinuteCount();
+    int getHourCount();
+    bool getRaw(int age, VeHistoryPoint& point);
+    bool getMinute(int age, VeHistorySample& sample);
+    bool getHour(int age, VeHistorySample& sample);
+
+  protected:
+    VeDirectHistoryBase(VeLabel label, VeHistoryPoint* raw, uint16_t rawLen,
+                        VeHistorySample* minutes, uint16_t minuteLen, VeHistorySample* hours, uint16_t hourLen);
+    VeDirectHistoryBase(const VeDirectHistoryBase&) = delete;
+    VeDirectHistoryBase& operator=(const VeDirectHistoryBase&) = delete;
+
+  private:
+    struct VeRing {
+      uint16_t len;                           // number of entries
+      uint16_t head;                          // next entry to write
+      uint16_t count;                         // number of used entries
+    };
+    struct VeAccumulator {
+      uint32_t start;                         // start of the interval
+      int32_t min;
+      int32_t max;
+      int64_t sum;
+      uint32_t count;                         // 0 if nothing was added yet
+    };
+
+    static uint16_t push(VeRing& ring);
+    static int index(const VeRing& ring, int age);
+    static void accumulate(VeAccumulator& acc, uint32_t start, int32_t value);
+    static void flush(VeAccumulator& acc, VeRing& ring, VeHistorySample* samples);
+    static void frameEvent(VeDirectFrameHandlerBase& handler, void* history);
+
+    VeLabel mLabel;                           // label of the history
+    veClockFunction mClock = nullptr;         // clock in seconds of attach()
+    VeDirectFrameHandlerBase* mHandler = nullptr; // handler of attach(), nullptr if not attached
+    int mHandle = -1;                         // frame callback at mHandler
+    VeHistoryPoint* mRaw;
+    VeHistorySample* mMinutes;
+    VeHistorySample* mHours;
+    VeRing mRawRing;
+    VeRing mMinuteRing;
+    VeRing mHourRing;
+    VeAccumulator mMinute = { };              // minute being aggregated
+    VeAccumulator mHour = { };                // hour being aggregated
+};
+
+/**
+ * @brief History with compile-time sized rings
+ * @details The default keeps the last minute of raw values, the last hour of minutes and the
+ *          last day of hours in about 2.2 KB, e.g. VeDirectHistoryT<> power(VE_LABEL_PPV).
+ */
+template <uint16_t RawLen = 60, uint16_t MinuteLen = 60, uint16_t HourLen = 24>
+class VeDirectHistoryT : public VeDirectHistoryBase {
+    static_assert(RawLen > 0 && MinuteLen > 0 && HourLen > 0, "rings must not be empty");
+
+  public:
+    VeDirectHistoryT(VeLabel label)
+      : VeDirectHistoryBase(label, mRawData, RawLen, mMinuteData, MinuteLen, mHourData, HourLen) {}
+
+  private:
+    VeHistoryPoint mRawData[RawLen] = { };
+    VeHistorySample mMinuteData[MinuteLen] = { };
+    VeHistorySample mHourData[HourLen] = { };
+};
+
+/**
+ * @brief Histories of several labels of one handler, recorded from a single frame callback
+ * @details Each history attached on its own takes a frame callback of the handler. A group
+ *          takes one for up to VEDIRECT_HISTORY_GROUP_MAX histories and reads the clock once
+ *          per frame. The histories must not be attached themselves.
+ *
+ *          VeDirectHistoryT<> power(VE_LABEL_PPV), battery(VE_LABEL_V);
+ *          VeDirectHistoryGroup group;
+ *          group.add(power);
+ *          group.add(battery);
+ *          if (group.attach(myve, seconds) < 0) ...   // no free frame callback
+ */
+class VeDirectHistoryGroup {
+  public:
+    VeDirectHistoryGroup() = default;
+    VeDirectHistoryGroup(const VeDirectHistoryGroup&) = delete;
+    VeDirectHistoryGroup& operator=(const VeDirectHistoryGroup&) = delete;
+
+    bool add(VeDirectHistoryBase& history);
+    int attach(VeDirectFrameHandlerBase& handler, veClockFunction clock);
+    bool detach();
+    int size();
+
+  private:
+    static void frameEvent(VeDirectFrameHandlerBase& handler, void* group);
+
+    VeDirectHistoryBase* mHistories[VEDIRECT_HISTORY_GROUP_MAX] = { };
+    int mCount = 0;                           // number of histories
+    veClockFunction mClock = nullptr;         // clock in seconds of attach()
+    VeDirectFrameHandlerBase* mHandler = nullptr; // handler of attach(), nullptr if not attached
+    int mHandle = -1;                         // frame callback at mHandler
+};
+
+#endif // VEDIRECTHISTORY_H_
@@ -0,0 +1,199 @@
+/* VeDirectHub.cpp
+ *
+ * Handles many VE.Direct ports with one poll loop and one set of callbacks.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - frame callbacks in a VeCallbackList, with handles and removal
+ */
+
+#include "VeDirectHub.h"
+
+/**
+ * @brief Construct a new hub
+ *
+ * @param clock Optional time source (e.g. millis) used to track the freshness of each port
+ */
+VeDirectHub::VeDirectHub(veClockFunction clock) : mClock(clock) {}
+
+/**
+ * @brief Destroy the hub
+ */
+VeDirectHub::~VeDirectHub() {}
+
+/**
+ * @brief Add a port to the hub
+ * @details The hub registers a frame callback at the handler to track the port.
+ *
+ * @param handler       Frame handler of the port
+ * @param readFunction  Non blocking read of the port, returning the number of bytes read.
+ *                      nullptr if the data is passed with feed() instead.
+ * @param readContext   Passed to readFunction
+ * @return int          Port number or -1 if VEDIRECT_HUB_MAX_PORTS is reached
+ */
+int VeDirectHub::addPort(VeDirectFrameHandlerBase& handler, veReadFunction readFunction, void* readContext) {
+  if (mNumPorts >= VEDIRECT_HUB_MAX_PORTS) return -1;
+  VePort& port = mPorts[mNumPorts];
+  if (handler.addFrameCallback(frameEvent, &port) < 0) return -1;
+  port.handler = &handler;
+  port.readFunction = readFunction;
+  port.readContext = readContext;
+  port.hub = this;
+  return mNumPorts++;
+}
+
+/**
+ * @brief This function allows you to call a function whenever any port received a valid frame
+ *
+ * @details Same registry as the callbacks of the frame handler. Up to 0.1 this returned the
+ *          number of registered callbacks, the handle is > 0 as well.
+ *
+ * @param cbFunction        Called with the hub and the port number
+ * @param cbAdditionalData
+ * @return int Handle (> 0) for removeFrameCallback or -1 if VEDIRECT_HUB_MAX_CALLBACKS is reached
+ */
+int VeDirectHub::addFrameCallback(hubFrameCallback cbFunction, void* cbAdditionalData) {
+  return addFrameCallback(hubFrameFunction(cbFunction, cbAdditionalData));
+}
+
+/**
+ * @brief Same as above, with a function or a reference to a callable object (e.g. a lambda)
+ * @details The callable is not copied, it must outlive the registration.
+ *
+ * @param cbFunction  Called with the hub and the port number
+ * @return int Handle (> 0) for removeFrameCallback or -1 if VEDIRECT_HUB_MAX_CALLBACKS is reached
+ */
+int VeDirectHub::addFrameCallback(hubFrameFunction cbFunction) {
+  return mCallBacks.add(cbFunction);
+}
+
+/**
+ * @brief Remove a callback registered with addFrameCallback
+ *
+ * @param handle  Result of addFrameCallback
+ * @return true   if the callback was removed
+ * @return false  if the handle is invalid or was already removed
+ */
+bool VeDirectHub::removeFrameCallback(int handle) {
+  return mCallBacks.remove(handle);
+}
+
+/**
+ * @brief Read all ports until they have no more data
+ * @details Each port is read in chunks of VEDIRECT_HUB_CHUNK bytes into the shared buffer and
+ *          parsed with the bulk parser. A port is done when a read returns less than a full chunk.
+ *
+ * @return int  Number of bytes processed
+ */
+int VeDirectHub::poll() {
+  int total = 0;
+  for (int i = 0; i < mNumPorts; i++) {
+    VePort& port = mPorts[i];
+    if (!port.readFunction) continue;
+    int len;
+    do {
+      len = port.readFunction(mBuffer, sizeof(mBuffer), port.readContext);
+      if (len <= 0) break;
+      port.handler->rxData(mBuffer, len);
+      total += len;
+    } while (len == (int)sizeof(mBuffer));
+  }
+  return total;
+}
+
+/**
+ * @brief Pass data of a port that was read by the application
+ *
+ * @param port    Port number
+ * @param buffer  Received bytes
+ * @param len     Number of bytes
+ */
+void VeDirectHub::feed(int port, const uint8_t* buffer, size_t len) {
+  if (port >= 0 && port < mNumPorts) mPorts[port].handler->rxData(buffer, len);
+}
+
+/**
+ * @brief Track the frame of a port and call the hub callbacks
+ *
+ * @param handler Frame handler that received the frame
+ * @param port    VePort of the handler
+ */
+void VeDirectHub::frameEvent(VeDirectFrameHandlerBase& handler, void* port) {
+  (void)handler;
+  VePort& p = *static_cast<VePort*>(port);
+  VeDirectHub& hub = *p.hub;
+  if (hub.mClock) p.lastFrame = hub.mClock();
+  p.seen = true;
+  int index = &p - hub.mPorts;
+  hub.mCallBacks.forEach([&](hubFrameFunction& cb) { cb(hub, index); });
+}
+
+/**
+ * @brief Get the number of ports
+ *
+ * @return int Number of ports
+ */
+int VeDirectHub::getPortCount() {
+  return mNumPorts;
+}
+
+/**
+ * @brief Get the frame handler of a port
+ *
+ * @param port  Port number
+ * @return VeDirectFrameHandlerBase* Handler or nullptr for an invalid port
+ */
+VeDirectFrameHandlerBase* VeDirectHub::getHandler(int port) {
+  return port >= 0 && port < mNumPorts ? mPorts[port].handler : nullptr;
+}
+
+/**
+ * @brief Get the current value of a label of a port
+ *
+ * @param port          Port number
+ * @param name          Name of the label (upper case, as received)
+ * @return const char*  Value or nullptr if the label was not received yet
+ */
+const char* VeDirectHub::getValue(int port, const char* name) {
+  VeDirectFrameHandlerBase* handler = getHandler(port);
+  return handler ? handler->getValue(name) : nullptr;
+}
+
+/**
+ * @brief Get the typed value of a known label of a port
+ *
+ * @param port    Port number
+ * @param label   Label id
+ * @param value   Parsed value, untouched if not available
+ * @return true   if the label was received with a valid value
+ * @return false  otherwise
+ */
+bool VeDirectHub::getTyped(int port, VeLabel label, int32_t& value) {
+  VeDirectFrameHandlerBase* handler = getHandler(port);
+  return handler ? handler->getTyped(label, value) : false;
+}
+
+/**
+ * @brief Get the number of valid frames received on a port
+ *
+ * @param port      Port number
+ * @return uint32_t Number of frames
+ */
+uint32_t VeDirectHub::getFrameCount(int port) {
+  VeDirectFrameHandlerBase* handler = getHandler(port);
+  return handler ? handler->getFrameCount() : 0;
+}
+
+/**
+ * @brief Check if a port received a valid frame recently
+ *
+ * @param port    Port number
+ * @param maxAge  Maximum age of the last frame, in units of the clock
+ * @return true   if the last frame is not older than maxAge
+ * @return false  if there is no clock, no frame yet or the last frame is too old
+ */
+bool VeDirectHub::isFresh(int port, uint32_t maxAge) {
+  if (!mClock || port < 0 || port >= mNumPorts || !mPorts[port].seen) return false;
+  return mClock() - mPorts[port].lastFrame <= maxAge;
+}
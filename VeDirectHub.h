@@ -0,0 +1,102 @@
+/* VeDirectHub.h
+ *
+ * Handles many VE.Direct ports with one poll loop and one set of callbacks.
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - frame callbacks in a VeCallbackList, with handles and removal
+ */
+
+#ifndef VEDIRECTHUB_H_
+#define VEDIRECTHUB_H_
+
+#include "VeDirectFrameHandler.h"
+
+#ifndef VEDIRECT_HUB_MAX_PORTS
+#define VEDIRECT_HUB_MAX_PORTS 32           // Number of ports of a hub, must be the same for library and application
+#endif
+#ifndef VEDIRECT_HUB_CHUNK
+#define VEDIRECT_HUB_CHUNK 256              // Size of the read buffer shared by all ports
+#endif
+#ifndef VEDIRECT_HUB_MAX_CALLBACKS
+#define VEDIRECT_HUB_MAX_CALLBACKS 4        // Number of frame callbacks of a hub (max 32), must be the same for library and application
+#endif
+
+class VeDirectHub;
+
+typedef int (*veReadFunction)(uint8_t* buffer, size_t size, void* context);
+typedef void (*hubFrameCallback)(VeDirectHub&, int, void*);
+typedef VeCallback<void(VeDirectHub&, int)> hubFrameFunction;
+
+/**
+ * @brief Collection of frame handlers, one per VE.Direct port
+ * @details The hub reads all ports through their read functions into one shared buffer, feeds
+ *          the chunks to the bulk parser and tracks when each port received its last valid frame.
+ *          Values are addressed by port number and label. The handlers are owned by the caller,
+ *          VeDirectHubT owns them instead.
+ */
+class VeDirectHub {
+  public:
+    VeDirectHub(veClockFunction clock = nullptr);
+    virtual ~VeDirectHub();
+
+    int addPort(VeDirectFrameHandlerBase& handler, veReadFunction readFunction = nullptr, void* readContext = nullptr);
+    int addFrameCallback(hubFrameCallback cbFunction, void* cbAdditionalData);
+    int addFrameCallback(hubFrameFunction cbFunction);
+    bool removeFrameCallback(int handle);
+    int poll();
+    void feed(int port, const uint8_t* buffer, size_t len);
+
+    int getPortCount();
+    VeDirectFrameHandlerBase* getHandler(int port);
+    const char* getValue(int port, const char* name);
+    bool getTyped(int port, VeLabel label, int32_t& value);
+    uint32_t getFrameCount(int port);
+    bool isFresh(int port, uint32_t maxAge);
+
+  private:
+    struct VePort {
+      VeDirectFrameHandlerBase* handler;    // parser of the port
+      veReadFunction readFunction;          // non blocking read, returns the bytes read, nullptr if the port is fed
+      void* readContext;                    // passed to read function, e.g. the serial port
+      uint32_t lastFrame;                   // clock at the last valid frame
+      bool seen;                            // at least one valid frame received
+      VeDirectHub* hub;                     // back pointer for the frame callback
+    };
+
+    static void frameEvent(VeDirectFrameHandlerBase& handler, void* port);
+
+    veClockFunction mClock;                 // time source for the freshness, optional
+    VePort mPorts[VEDIRECT_HUB_MAX_PORTS] = { };
+    int mNumPorts = 0;                      // number of ports in use
+    VeCallbackList<hubFrameFunction, VEDIRECT_HUB_MAX_CALLBACKS> mCallBacks; // called for each valid frame of any port
+    uint8_t mBuffer[VEDIRECT_HUB_CHUNK];    // read buffer shared by all ports
+};
+
+/**
+ * @brief Hub that owns the frame handlers of its ports
+ * @details Handler is the type of the frame handlers, e.g. VeDirectFrameHandlerT<20, 20, 80> for
+ *          a fleet of MPPTs. Ports are added with addPort(readFunction, readContext).
+ *          Every port has a complete handler: the parser state and both stores can't be shared,
+ *          as each port is in the middle of its own frame. The hub takes NumPorts * sizeof(Handler),
+ *          so size the handlers for the devices connected (or use VeDirectHub with handlers of
+ *          different sizes). Only the read buffer and the callbacks are shared.
+ */
+template <int NumPorts, typename Handler = VeDirectFrameHandler>
+class VeDirectHubT : public VeDirectHub {
+    static_assert(NumPorts > 0 && NumPorts <= VEDIRECT_HUB_MAX_PORTS, "NumPorts must be within 1..VEDIRECT_HUB_MAX_PORTS");
+
+  public:
+    VeDirectHubT(veClockFunction clock = nullptr) : VeDirectHub(clock) {}
+
+    int addPort(veReadFunction readFunction = nullptr, void* readContext = nullptr) {
+      int port = getPortCount();
+      if (port >= NumPorts) return -1;
+      return VeDirectHub::addPort(mHandlers[port], readFunction, readContext);
+    }
+    Handler& operator[](int port) { return mHandlers[port]; }
+
+  private:
+    Handler mHandlers[NumPorts];
+};
+
+#endif // VEDIRECTHUB_H_
@@ -0,0 +1,183 @@
+/* VeDirectLabels.cpp
+ *
+ * Known labels of the VE.Direct TEXT protocol and the type of their values.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - hash lookup of the label ids while the name streams in
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "VeDirectLabels.h"
+
+// Must be kept in the order of enum VeLabel
+constexpr VeLabelInfo veLabels[VE_LABEL_COUNT] = {
+  { "V",        VE_TYPE_INT },
+  { "V2",       VE_TYPE_INT },
+  { "V3",       VE_TYPE_INT },
+  { "VS",       VE_TYPE_INT },
+  { "VM",       VE_TYPE_INT },
+  { "DM",       VE_TYPE_INT },
+  { "VPV",      VE_TYPE_INT },
+  { "PPV",      VE_TYPE_INT },
+  { "I",        VE_TYPE_INT },
+  { "I2",       VE_TYPE_INT },
+  { "I3",       VE_TYPE_INT },
+  { "IL",       VE_TYPE_INT },
+  { "LOAD",     VE_TYPE_ONOFF },
+  { "T",        VE_TYPE_INT },
+  { "P",        VE_TYPE_INT },
+  { "CE",       VE_TYPE_INT },
+  { "SOC",      VE_TYPE_INT },
+  { "TTG",      VE_TYPE_INT },
+  { "ALARM",    VE_TYPE_ONOFF },
+  { "RELAY",    VE_TYPE_ONOFF },
+  { "AR",       VE_TYPE_INT },
+  { "OR",       VE_TYPE_HEX },
+  { "H1",       VE_TYPE_INT },
+  { "H2",       VE_TYPE_INT },
+  { "H3",       VE_TYPE_INT },
+  { "H4",       VE_TYPE_INT },
+  { "H5",       VE_TYPE_INT },
+  { "H6",       VE_TYPE_INT },
+  { "H7",       VE_TYPE_INT },
+  { "H8",       VE_TYPE_INT },
+  { "H9",       VE_TYPE_INT },
+  { "H10",      VE_TYPE_INT },
+  { "H11",      VE_TYPE_INT },
+  { "H12",      VE_TYPE_INT },
+  { "H13",      VE_TYPE_INT },
+  { "H14",      VE_TYPE_INT },
+  { "H15",      VE_TYPE_INT },
+  { "H16",      VE_TYPE_INT },
+  { "H17",      VE_TYPE_INT },
+  { "H18",      VE_TYPE_INT },
+  { "H19",      VE_TYPE_INT },
+  { "H20",      VE_TYPE_INT },
+  { "H21",      VE_TYPE_INT },
+  { "H22",      VE_TYPE_INT },
+  { "H23",      VE_TYPE_INT },
+  { "ERR",      VE_TYPE_INT },
+  { "CS",       VE_TYPE_INT },
+  { "BMV",      VE_TYPE_STRING },
+  { "FW",       VE_TYPE_STRING },
+  { "FWE",      VE_TYPE_STRING },
+  { "PID",      VE_TYPE_HEX },
+  { "SER#",     VE_TYPE_STRING },
+  { "HSDS",     VE_TYPE_INT },
+  { "MODE",     VE_TYPE_INT },
+  { "AC_OUT_V", VE_TYPE_INT },
+  { "AC_OUT_I", VE_TYPE_INT },
+  { "AC_OUT_S", VE_TYPE_INT },
+  { "WARN",     VE_TYPE_INT },
+  { "MPPT",     VE_TYPE_INT },
+  { "MON",      VE_TYPE_INT },
+  { "DC_IN_V",  VE_TYPE_INT },
+  { "DC_IN_I",  VE_TYPE_INT },
+  { "DC_IN_P",  VE_TYPE_INT },
+  { "CHECKSUM", VE_TYPE_STRING },
+};
+
+#define LABEL_TABLE_LEN 128                  // power of 2, at least twice VE_LABEL_COUNT
+
+static_assert(LABEL_TABLE_LEN >= 2 * VE_LABEL_COUNT, "LABEL_TABLE_LEN is too small");
+
+struct VeLabelTable {
+  uint8_t bucket[LABEL_TABLE_LEN];           // label id + 1, 0 if unused
+};
+
+static constexpr uint32_t labelBucket(uint32_t hash) {
+  return (hash ^ (hash >> 16)) & (LABEL_TABLE_LEN - 1);
+}
+
+static constexpr uint32_t constLabelHash(const char* name) {
+  uint32_t hash = veLabelHashSeed;
+  while (*name) hash = veLabelHashStep(hash, (uint8_t)*name++);
+  return hash;
+}
+
+// open addressing table of the known labels, built at compile time
+static constexpr VeLabelTable makeLabelTable() {
+  VeLabelTable table = { };
+  for (uint8_t i = 0; i < VE_LABEL_COUNT; i++) {
+    uint32_t bucket = labelBucket(constLabelHash(veLabels[i].name));
+    while (table.bucket[bucket]) bucket = (bucket + 1) & (LABEL_TABLE_LEN - 1);
+    table.bucket[bucket] = i + 1;
+  }
+  return table;
+}
+
+static constexpr VeLabelTable labelTable = makeLabelTable();
+
+/**
+ * @brief Hash a label name (FNV-1a), the same as hashing it with veLabelHashStep byte by byte
+ *
+ * @param name      Zero terminated label name
+ * @return uint32_t Hash value
+ */
+uint32_t veLabelHash(const char* name) {
+  return constLabelHash(name);
+}
+
+/**
+ * @brief Get the label id of a label name with a known hash
+ *
+ * @param hash      veLabelHash of name
+ * @param name      Label name, upper case as stored by the frame handler
+ * @return VeLabel  Label id or VE_LABEL_UNKNOWN
+ */
+VeLabel veLabelFromHash(uint32_t hash, const char* name) {
+  for (uint32_t bucket = labelBucket(hash); labelTable.bucket[bucket]; bucket = (bucket + 1) & (LABEL_TABLE_LEN - 1)) {
+    uint8_t label = labelTable.bucket[bucket] - 1;
+    if (strcmp(veLabels[label].name, name) == 0) return (VeLabel)label;
+  }
+  return VE_LABEL_UNKNOWN;
+}
+
+/**
+ * @brief Get the label id of a label name
+ *
+ * @param name      Label name, upper case as stored by the frame handler
+ * @return VeLabel  Label id or VE_LABEL_UNKNOWN
+ */
+VeLabel veLabelFromName(const char* name) {
+  return veLabelFromHash(veLabelHash(name), name);
+}
+
+/**
+ * @brief Parse a TEXT value into an integer
+ *
+ * @param type    Type of the value, see VeLabelInfo
+ * @param value   Value as received
+ * @param result  Parsed value, untouched on error
+ * @return true   if the value was parsed completely
+ * @return false  for strings and malformed values (e.g. "---" for unavailable values)
+ */
+bool veParseValue(VeValueType type, const char* value, int32_t& result) {
+  char* end = nullptr;
+  switch (type) {
+    case VE_TYPE_INT: {
+      long parsed = strtol(value, &end, 10);
+      if (end == value || *end != 0) return false;
+      result = (int32_t)parsed;
+      return true;
+    }
+    case VE_TYPE_HEX: {
+      if (value[0] != '0' || (value[1] != 'x' && value[1] != 'X')) return false;
+      unsigned long parsed = strtoul(value + 2, &end, 16);
+      if (end == value + 2 || *end != 0) return false;
+      result = (int32_t)parsed;
+      return true;
+    }
+    case VE_TYPE_ONOFF:
+      if (strcmp(value, "ON") == 0) result = 1;
+      else if (strcmp(value, "OFF") == 0) result = 0;
+      else return false;
+      return true;
+    default:
+      return false;
+  }
+}
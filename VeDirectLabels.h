@@ -0,0 +1,134 @@
+/* VeDirectLabels.h
+ *
+ * Known labels of the VE.Direct TEXT protocol and the type of their values.
+ * Based on the VE.Direct Protocol version 3.33.
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - hash lookup of the label ids while the name streams in
+ * 2026.10.14 - 0.3 - VeLabelMask shared by the serializers and the publish policies
+ */
+
+#ifndef VEDIRECTLABELS_H_
+#define VEDIRECTLABELS_H_
+
+#include <stdint.h>
+
+enum VeLabel : uint8_t {
+  VE_LABEL_V,                                 // mV     main or channel 1 (battery) voltage
+  VE_LABEL_V2,                                // mV     channel 2 (battery) voltage
+  VE_LABEL_V3,                                // mV     channel 3 (battery) voltage
+  VE_LABEL_VS,                                // mV     auxiliary (starter) voltage
+  VE_LABEL_VM,                                // mV     mid-point voltage of the battery bank
+  VE_LABEL_DM,                                // permille mid-point deviation of the battery bank
+  VE_LABEL_VPV,                               // mV     panel voltage
+  VE_LABEL_PPV,                               // W      panel power
+  VE_LABEL_I,                                 // mA     main or channel 1 battery current
+  VE_LABEL_I2,                                // mA     channel 2 battery current
+  VE_LABEL_I3,                                // mA     channel 3 battery current
+  VE_LABEL_IL,                                // mA     load current
+  VE_LABEL_LOAD,                              //        load output state (ON/OFF)
+  VE_LABEL_T,                                 // degC   battery temperature
+  VE_LABEL_P,                                 // W      instantaneous power
+  VE_LABEL_CE,                                // mAh    consumed amp hours
+  VE_LABEL_SOC,                               // permille state-of-charge
+  VE_LABEL_TTG,                               // min    time-to-go
+  VE_LABEL_ALARM,                             //        alarm condition active (ON/OFF)
+  VE_LABEL_RELAY,                             //        relay state (ON/OFF)
+  VE_LABEL_AR,                                //        alarm reason
+  VE_LABEL_OR,                                //        off reason
+  VE_LABEL_H1,                                // mAh    depth of the deepest discharge
+  VE_LABEL_H2,                                // mAh    depth of the last discharge
+  VE_LABEL_H3,                                // mAh    depth of the average discharge
+  VE_LABEL_H4,                                //        number of charge cycles
+  VE_LABEL_H5,                                //        number of full discharges
+  VE_LABEL_H6,                                // mAh    cumulative amp hours drawn
+  VE_LABEL_H7,                                // mV     minimum main (battery) voltage
+  VE_LABEL_H8,                                // mV     maximum main (battery) voltage
+  VE_LABEL_H9,                                // s      number of seconds since last full charge
+  VE_LABEL_H10,                               //        number of automatic synchronizations
+  VE_LABEL_H11,                               //        number of low main voltage alarms
+  VE_LABEL_H12,                               //        number of high main voltage alarms
+  VE_LABEL_H13,                               //        number of low auxiliary voltage alarms
+  VE_LABEL_H14,                               //        number of high auxiliary voltage alarms
+  VE_LABEL_H15,                               // mV     minimum auxiliary (battery) voltage
+  VE_LABEL_H16,                               // mV     maximum auxiliary (battery) voltage
+  VE_LABEL_H17,                               // 0.01kWh amount of discharged energy
+  VE_LABEL_H18,                               // 0.01kWh amount of charged energy
+  VE_LABEL_H19,                               // 0.01kWh yield total (user resettable counter)
+  VE_LABEL_H20,                               // 0.01kWh yield today
+  VE_LABEL_H21,                               // W      maximum power today
+  VE_LABEL_H22,                               // 0.01kWh yield yesterday
+  VE_LABEL_H23,                               // W      maximum power yesterday
+  VE_LABEL_ERR,                               //        error code
+  VE_LABEL_CS,                                //        state of operation, see VeChargeState
+  VE_LABEL_BMV,                               //        model description (deprecated)
+  VE_LABEL_FW,                                //        firmware version (16 bit)
+  VE_LABEL_FWE,                               //        firmware version (24 bit)
+  VE_LABEL_PID,                               //        product id
+  VE_LABEL_SER,                               //        serial number (SER#)
+  VE_LABEL_HSDS,                              //        day sequence number (0..364)
+  VE_LABEL_MODE,                              //        device mode
+  VE_LABEL_AC_OUT_V,                          // 0.01V  AC output voltage
+  VE_LABEL_AC_OUT_I,                          // 0.1A   AC output current
+  VE_LABEL_AC_OUT_S,                          // VA     AC output apparent power
+  VE_LABEL_WARN,                              //        warning reason
+  VE_LABEL_MPPT,                              //        tracker operation mode
+  VE_LABEL_MON,                               //        DC monitor mode
+  VE_LABEL_DC_IN_V,                           // 0.01V  DC input voltage
+  VE_LABEL_DC_IN_I,                           // 0.1A   DC input current
+  VE_LABEL_DC_IN_P,                           // W      DC input power
+  VE_LABEL_CHECKSUM,                          //        end of the frame
+  VE_LABEL_COUNT,
+  VE_LABEL_UNKNOWN = 0xFF
+};
+
+enum VeValueType : uint8_t {
+  VE_TYPE_INT,                                // signed decimal number
+  VE_TYPE_HEX,                                // hexadecimal number with 0x prefix
+  VE_TYPE_ONOFF,                              // ON or OFF, stored as 1 or 0
+  VE_TYPE_STRING                              // free text, not available as typed value
+};
+
+enum VeChargeState : uint8_t {                // values of the CS label
+  VE_CS_OFF = 0,
+  VE_CS_LOW_POWER = 1,
+  VE_CS_FAULT = 2,
+  VE_CS_BULK = 3,
+  VE_CS_ABSORPTION = 4,
+  VE_CS_FLOAT = 5,
+  VE_CS_STORAGE = 6,
+  VE_CS_EQUALIZE = 7,
+  VE_CS_INVERTING = 9,
+  VE_CS_POWER_SUPPLY = 11,
+  VE_CS_STARTING_UP = 245,
+  VE_CS_REPEATED_ABSORPTION = 246,
+  VE_CS_AUTO_EQUALIZE = 247,
+  VE_CS_BATTERY_SAFE = 248,
+  VE_CS_EXTERNAL_CONTROL = 252
+};
+
+struct VeLabelInfo {
+  const char* name;                           // label name, upper case as stored by the frame handler
+  VeValueType type;                           // how the value is parsed into the typed store
+};
+
+extern const VeLabelInfo veLabels[VE_LABEL_COUNT];
+
+// mask of label ids, bit (label % 32) of word (label / 32)
+typedef uint32_t VeLabelMask[(VE_LABEL_COUNT + 31) / 32];
+
+const uint32_t veLabelHashSeed = 2166136261u;  // FNV-1a offset basis
+
+/**
+ * @brief One FNV-1a step, the frame handler hashes names byte by byte while receiving them
+ */
+constexpr uint32_t veLabelHashStep(uint32_t hash, uint8_t c) {
+  return (hash ^ c) * 16777619u;
+}
+
+uint32_t veLabelHash(const char* name);
+VeLabel veLabelFromHash(uint32_t hash, const char* name);
+VeLabel veLabelFromName(const char* name);
+bool veParseValue(VeValueType type, const char* value, int32_t& result);
+
+#endif // VEDIRECTLABELS_H_
@@ -0,0 +1,222 @@
+/* VeDirectLinuxSerial.cpp
+ *
+ * Reads many VE.Direct ttys on Linux from one thread with epoll.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - VMIN 1 so an empty tty reports EAGAIN, hangups from epoll reported by callback
+ */
+
+#if defined(__linux__)
+
+#include "VeDirectLinuxSerial.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define EPOLL_EVENTS 16                     // events handled per epoll_wait
+
+/**
+ * @brief Construct a new reader
+ * @details Creating the epoll instance may fail, open() and add() then return -1.
+ */
+VeDirectLinuxSerial::VeDirectLinuxSerial() :
+  mEpoll(epoll_create1(EPOLL_CLOEXEC)),
+  mNumTtys(0)
+{
+}
+
+/**
+ * @brief Destroy the reader and close all ttys
+ */
+VeDirectLinuxSerial::~VeDirectLinuxSerial() {
+  close();
+  if (mEpoll >= 0) ::close(mEpoll);
+}
+
+/**
+ * @brief Open a tty raw and non blocking with 19200 8N1
+ *
+ * @param device  Path of the tty, e.g. /dev/ttyUSB0
+ * @return int    File descriptor or -1
+ */
+int VeDirectLinuxSerial::openTty(const char* device) {
+  int fd = ::open(device, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) return -1;
+
+  struct termios tio;
+  if (tcgetattr(fd, &tio) < 0) {
+    int err = errno;
+    ::close(fd);
+    errno = err;
+    return -1;
+  }
+  cfmakeraw(&tio);
+  tio.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+  tio.c_cflag |= CLOCAL | CREAD | CS8;
+  tio.c_cc[VMIN] = 1;                       // with O_NONBLOCK: EAGAIN without data, 0 only at a hangup
+  tio.c_cc[VTIME] = 0;
+  cfsetispeed(&tio, B19200);
+  cfsetospeed(&tio, B19200);
+  if (tcsetattr(fd, TCSANOW, &tio) < 0) {
+    int err = errno;
+    ::close(fd);
+    errno = err;
+    return -1;
+  }
+  tcflush(fd, TCIFLUSH);
+  return fd;
+}
+
+/**
+ * @brief Open a tty and add it to the reader
+ *
+ * @param device  Path of the tty, e.g. /dev/ttyUSB0
+ * @param handler Frame handler that receives the data of the tty
+ * @return int    Port number or -1
+ */
+int VeDirectLinuxSerial::open(const char* device, VeDirectFrameHandlerBase& handler) {
+  int fd = openTty(device);
+  if (fd < 0) return -1;
+  int port = add(fd, handler);
+  if (port < 0) {
+    int err = errno;
+    ::close(fd);
+    errno = err;
+  }
+  return port;
+}
+
+/**
+ * @brief Add an already opened non blocking file descriptor, e.g. a pipe or socket
+ * @details The reader takes the ownership of fd and closes it in close().
+ *
+ * @param fd      Non blocking file descriptor
+ * @param handler Frame handler that receives the data of fd
+ * @return int    Port number or -1
+ */
+int VeDirectLinuxSerial::add(int fd, VeDirectFrameHandlerBase& handler) {
+  if (mEpoll < 0) {
+    errno = EBADF;
+    return -1;
+  }
+  if (mNumTtys >= VEDIRECT_LINUX_MAX_PORTS) {
+    errno = ENOSPC;
+    return -1;
+  }
+  struct epoll_event ev = { };
+  ev.events = EPOLLIN;
+  ev.data.u32 = mNumTtys;
+  if (epoll_ctl(mEpoll, EPOLL_CTL_ADD, fd, &ev) < 0) return -1;
+  mTtys[mNumTtys].fd = fd;
+  mTtys[mNumTtys].handler = &handler;
+  mTtys[mNumTtys].open = true;
+  return mNumTtys++;
+}
+
+/**
+ * @brief Wait for data and pass it to the handlers
+ * @details Every ready tty is read until it has no more data, so one wakeup handles everything
+ *          that arrived meanwhile. Call it in a loop from the reader thread.
+ *          A tty that hung up (EPOLLHUP or EPOLLERR, e.g. an unplugged USB adapter) or fails to
+ *          read is removed from the wait after its remaining data was read, and reported to the
+ *          hangup callback. isOpen() is false for it from then on.
+ *
+ * @param timeoutMs Maximum time to wait, -1 to wait forever, 0 to return immediately
+ * @return int      Number of bytes processed, 0 on timeout or -1 on errors
+ */
+int VeDirectLinuxSerial::poll(int timeoutMs) {
+  struct epoll_event events[EPOLL_EVENTS];
+  int ready = epoll_wait(mEpoll, events, EPOLL_EVENTS, timeoutMs);
+  if (ready < 0) return errno == EINTR ? 0 : -1;
+
+  int total = 0;
+  for (int i = 0; i < ready; i++) {
+    int port = events[i].data.u32;
+    VeTty& tty = mTtys[port];
+    bool hangup = events[i].events & (EPOLLHUP | EPOLLERR);
+    for (;;) {
+      ssize_t len = ::read(tty.fd, mBuffer, sizeof(mBuffer));
+      if (len > 0) {
+        tty.handler->rxData(mBuffer, len);
+        total += len;
+        if (len < (ssize_t)sizeof(mBuffer) && !hangup) break;
+      } else if (len < 0 && errno == EINTR) {
+        continue;
+      } else {
+        if (len < 0 && errno != EAGAIN) hangup = true;      // e.g. EIO of a vanished tty
+        break;                                              // EAGAIN: all read, 0: end of data
+      }
+    }
+    if (hangup) {
+      epoll_ctl(mEpoll, EPOLL_CTL_DEL, tty.fd, nullptr);
+      tty.open = false;
+      if (mHangupCallBack) mHangupCallBack(port, mHangupData);
+    }
+  }
+  return total;
+}
+
+/**
+ * @brief This function allows you to call a function when a tty hung up and was removed from the wait
+ *
+ * @param cbFunction        Called with the port number, nullptr to remove the callback
+ * @param cbAdditionalData
+ */
+void VeDirectLinuxSerial::setHangupCallback(ttyHangupCallback cbFunction, void* cbAdditionalData) {
+  mHangupCallBack = cbFunction;
+  mHangupData = cbAdditionalData;
+}
+
+/**
+ * @brief Check if a tty is still read
+ *
+ * @param port    Port number
+ * @return true   if the tty is part of the wait
+ * @return false  for an invalid port or a tty that hung up
+ */
+bool VeDirectLinuxSerial::isOpen(int port) {
+  return port >= 0 && port < mNumTtys && mTtys[port].open;
+}
+
+/**
+ * @brief Close all ttys
+ */
+void VeDirectLinuxSerial::close() {
+  for (int i = 0; i < mNumTtys; i++) ::close(mTtys[i].fd);
+  mNumTtys = 0;
+}
+
+/**
+ * @brief Get the number of ttys
+ *
+ * @return int Number of ttys
+ */
+int VeDirectLinuxSerial::getPortCount() {
+  return mNumTtys;
+}
+
+/**
+ * @brief Get the file descriptor of a tty, e.g. to send HEX commands
+ *
+ * @param port  Port number
+ * @return int  File descriptor or -1 for an invalid port
+ */
+int VeDirectLinuxSerial::getFd(int port) {
+  return port >= 0 && port < mNumTtys ? mTtys[port].fd : -1;
+}
+
+/**
+ * @brief Get the epoll file descriptor, to wait for it in an outer event loop
+ *
+ * @return int File descriptor
+ */
+int VeDirectLinuxSerial::getEpollFd() {
+  return mEpoll;
+}
+
+#endif // __linux__
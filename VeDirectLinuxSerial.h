@@ -0,0 +1,68 @@
+/* VeDirectLinuxSerial.h
+ *
+ * Reads many VE.Direct ttys on Linux from one thread with epoll.
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - report hangups of ttys by callback
+ */
+
+#ifndef VEDIRECTLINUXSERIAL_H_
+#define VEDIRECTLINUXSERIAL_H_
+
+#if defined(__linux__)
+
+#include "VeDirectFrameHandler.h"
+
+#ifndef VEDIRECT_LINUX_MAX_PORTS
+#define VEDIRECT_LINUX_MAX_PORTS 64         // Number of ttys of one reader, must be the same for library and application
+#endif
+#ifndef VEDIRECT_LINUX_CHUNK
+#define VEDIRECT_LINUX_CHUNK 1024           // Size of the read buffer shared by all ttys
+#endif
+
+typedef void (*ttyHangupCallback)(int, void*);
+
+/**
+ * @brief epoll based reader for VE.Direct ttys
+ * @details Opens the ttys raw with 19200 8N1, waits for data on all of them with one epoll_wait()
+ *          and passes each read chunk to the bulk parser of the handler of the tty.
+ *          Functions that fail return -1 and leave the reason in errno.
+ */
+class VeDirectLinuxSerial {
+  public:
+    VeDirectLinuxSerial();
+    ~VeDirectLinuxSerial();
+    VeDirectLinuxSerial(const VeDirectLinuxSerial&) = delete;
+    VeDirectLinuxSerial& operator=(const VeDirectLinuxSerial&) = delete;
+
+    int open(const char* device, VeDirectFrameHandlerBase& handler);
+    int add(int fd, VeDirectFrameHandlerBase& handler);
+    int poll(int timeoutMs);
+    void setHangupCallback(ttyHangupCallback cbFunction, void* cbAdditionalData);
+    bool isOpen(int port);
+    void close();
+
+    int getPortCount();
+    int getFd(int port);
+    int getEpollFd();
+
+    static int openTty(const char* device);
+
+  private:
+    struct VeTty {
+      int fd;                               // file descriptor of the tty
+      VeDirectFrameHandlerBase* handler;    // parser of the tty
+      bool open;                            // false after a hangup, no longer waited for
+    };
+
+    int mEpoll;                             // epoll instance, -1 if it could not be created
+    VeTty mTtys[VEDIRECT_LINUX_MAX_PORTS];
+    int mNumTtys;                           // number of ttys in use
+    uint8_t mBuffer[VEDIRECT_LINUX_CHUNK];  // read buffer shared by all ttys
+    ttyHangupCallback mHangupCallBack = nullptr; // function to call when a tty hung up
+    void* mHangupData = nullptr;            // optional additional data send to hangup function
+};
+
+#endif // __linux__
+
+#endif // VEDIRECTLINUXSERIAL_H_
@@ -0,0 +1,71 @@
+/* VeDirectPlatform.h
+ *
+ * Platform checks and the atomic counter used by the lock-free readers.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ */
+
+#ifndef VEDIRECTPLATFORM_H_
+#define VEDIRECTPLATFORM_H_
+
+#include <stdint.h>
+
+#ifndef VEDIRECT_HAS_ATOMIC
+#if defined(__AVR__)
+#define VEDIRECT_HAS_ATOMIC 0               // avr-gcc ships no C++ library
+#elif defined(__has_include)
+#if __has_include(<atomic>)
+#define VEDIRECT_HAS_ATOMIC 1               // std::atomic for readers on other cores, must be the same for library and application
+#else
+#define VEDIRECT_HAS_ATOMIC 0
+#endif
+#else
+#define VEDIRECT_HAS_ATOMIC 1
+#endif
+#endif
+
+#if VEDIRECT_HAS_ATOMIC
+#include <atomic>
+#endif
+
+/**
+ * @brief Counter written by one task and read by others, e.g. the seqlock of the snapshots
+ * @details With VEDIRECT_HAS_ATOMIC it is a std::atomic with acquire loads and release stores.
+ *          Without, it is a volatile integer and the fences only keep the compiler from moving
+ *          memory accesses across them. That is enough on a single core, but a 32 bit value is
+ *          not read atomically on an 8 bit CPU: read it from the task that writes it, not from
+ *          an interrupt.
+ */
+class VeAtomicCounter {
+  public:
+    uint32_t load() const;                  // acquire
+    uint32_t loadRelaxed() const;
+    void store(uint32_t value);             // release
+    static void acquireFence();
+    static void releaseFence();
+
+  private:
+#if VEDIRECT_HAS_ATOMIC
+    std::atomic<uint32_t> mValue{0};
+#else
+    volatile uint32_t mValue = 0;
+#endif
+};
+
+#if VEDIRECT_HAS_ATOMIC
+inline uint32_t VeAtomicCounter::load() const { return mValue.load(std::memory_order_acquire); }
+inline uint32_t VeAtomicCounter::loadRelaxed() const { return mValue.load(std::memory_order_relaxed); }
+inline void VeAtomicCounter::store(uint32_t value) { mValue.store(value, std::memory_order_release); }
+inline void VeAtomicCounter::acquireFence() { std::atomic_thread_fence(std::memory_order_acquire); }
+inline void VeAtomicCounter::releaseFence() { std::atomic_thread_fence(std::memory_order_release); }
+#else
+inline uint32_t VeAtomicCounter::load() const { return mValue; }
+inline uint32_t VeAtomicCounter::loadRelaxed() const { return mValue; }
+inline void VeAtomicCounter::store(uint32_t value) { mValue = value; }
+inline void VeAtomicCounter::acquireFence() { __asm__ __volatile__("" ::: "memory"); }
+inline void VeAtomicCounter::releaseFence() { __asm__ __volatile__("" ::: "memory"); }
+#endif
+
+#endif // VEDIRECTPLATFORM_H_
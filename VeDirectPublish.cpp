@@ -0,0 +1,136 @@
+/* VeDirectPublish.cpp
+ *
+ * Per label policies that decide which received values are worth publishing.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - text changes compared with the previous frame, a hash collision could hide a change
+ */
+
+#include "VeDirectPublish.h"
+
+#include <string.h>
+
+static bool testBit(const uint32_t* mask, int bit) {
+  return mask[bit / 32] & (1u << (bit % 32));
+}
+
+static void setBit(uint32_t* mask, int bit, bool value) {
+  if (value) mask[bit / 32] |= 1u << (bit % 32);
+  else mask[bit / 32] &= ~(1u << (bit % 32));
+}
+
+/**
+ * @brief Construct a new publisher, all labels are published on change
+ *
+ * @param clock   Time source of the intervals, e.g. millis, nullptr to ignore the intervals
+ */
+VePublisher::VePublisher(veClockFunction clock) : mClock(clock) {
+  setPolicy({ VE_PUBLISH_ON_CHANGE, 0, 0, 0 });
+  reset();
+}
+
+/**
+ * @brief Set the policy of one label
+ *
+ * @param label   Label id
+ * @param policy  Policy to use for the label
+ */
+void VePublisher::setPolicy(VeLabel label, const VePublishPolicy& policy) {
+  if (label < VE_LABEL_COUNT) mPolicies[label] = policy;
+}
+
+/**
+ * @brief Set the policy of all labels, e.g. before setting the exceptions per label
+ */
+void VePublisher::setPolicy(const VePublishPolicy& policy) {
+  for (uint8_t label = 0; label < VE_LABEL_COUNT; label++) mPolicies[label] = policy;
+}
+
+/**
+ * @brief Forget the published values, the next frame publishes every received label again
+ */
+void VePublisher::reset() {
+  memset(mLast, 0, sizeof(mLast));
+  memset(mLastTime, 0, sizeof(mLastTime));
+  memset(mSeen, 0, sizeof(mSeen));
+  memset(mLastTyped, 0, sizeof(mLastTyped));
+  memset(mTextPending, 0, sizeof(mTextPending));
+  memset(mMask, 0, sizeof(mMask));
+}
+
+const uint32_t* VePublisher::getMask() {
+  return mMask;
+}
+
+bool VePublisher::isPublished(VeLabel label) {
+  return label < VE_LABEL_COUNT && testBit(mMask, label);
+}
+
+/**
+ * @brief Decide if the record of a known label is published and remember it if so
+ * @details Texts are compared with the previous frame, not with the last published text, so a
+ *          change that is not published yet is remembered in mTextPending.
+ */
+bool VePublisher::decide(uint8_t label, const VeDirectFrameHandlerBase::VeStore& front, const VeDirectFrameHandlerBase::VeStore& previous,
+                         int slot, uint32_t now) {
+  const VePublishPolicy& policy = mPolicies[label];
+  if (policy.mode == VE_PUBLISH_NEVER) return false;
+
+  bool typed = front.isTyped(slot);
+  bool seen = testBit(mSeen, label);
+  bool changed = !seen || typed != testBit(mLastTyped, label);
+  if (!changed && typed) {
+    int64_t delta = (int64_t)front.typedValue[slot] - mLast[label];
+    changed = delta > policy.deadband || -delta > policy.deadband;
+  } else if (!typed) {
+    int previousSlot = previous.slotOf(label);
+    if (previousSlot < 0 || strcmp(front.data[slot].veValue, previous.data[previousSlot].veValue) != 0) {
+      setBit(mTextPending, label, true);
+    }
+    changed |= testBit(mTextPending, label);
+  }
+
+  uint32_t elapsed = now - mLastTime[label];
+  bool publish = policy.mode == VE_PUBLISH_ALWAYS || changed;
+  if (publish && seen && mClock && elapsed < policy.minInterval) publish = false;
+  if (!publish && seen && mClock && policy.maxInterval && elapsed >= policy.maxInterval) publish = true;
+  if (!publish) return false;
+
+  mLast[label] = typed ? front.typedValue[slot] : 0;
+  mLastTime[label] = now;
+  setBit(mSeen, label, true);
+  setBit(mLastTyped, label, typed);
+  setBit(mTextPending, label, false);
+  return true;
+}
+
+/**
+ * @brief Evaluate the policies for a committed frame, called by the frame handler
+ *
+ * @param front     Store with the new frame
+ * @param previous  Store with the frame before
+ * @param touched   Slots written by the new frame, (front.end + 31) / 32 words
+ * @param published Output, slots of the new frame to publish, as many words as touched
+ */
+void VePublisher::evaluate(const VeDirectFrameHandlerBase::VeStore& front, const VeDirectFrameHandlerBase::VeStore& previous,
+                           const uint32_t* touched, uint32_t* published) {
+  uint32_t now = mClock ? mClock() : 0;
+  memset(mMask, 0, sizeof(mMask));
+  for (int j = 0; j < (front.end + 31) / 32; j++) {
+    published[j] = 0;
+    for (uint32_t bits = touched[j]; bits; bits &= bits - 1) {
+      int slot = j * 32 + __builtin_ctz(bits);
+      uint8_t label = front.slotLabel[slot];
+      bool publish;
+      if (label < VE_LABEL_COUNT) {
+        publish = decide(label, front, previous, slot, now);
+        if (publish) setBit(mMask, label, true);
+      } else {
+        publish = slot >= previous.end || strcmp(front.data[slot].veValue, previous.data[slot].veValue) != 0;
+      }
+      if (publish) published[j] |= 1u << (slot % 32);
+    }
+  }
+}
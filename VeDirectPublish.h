@@ -0,0 +1,66 @@
+/* VeDirectPublish.h
+ *
+ * Per label policies that decide which received values are worth publishing.
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - text changes compared with the previous frame instead of a hash
+ */
+
+#ifndef VEDIRECTPUBLISH_H_
+#define VEDIRECTPUBLISH_H_
+
+#include "VeDirectFrameHandler.h"
+
+enum VePublishMode : uint8_t {
+  VE_PUBLISH_ON_CHANGE,                     // when the value differs from the last published one
+  VE_PUBLISH_ALWAYS,                        // every received value
+  VE_PUBLISH_NEVER                          // not at all
+};
+
+struct VePublishPolicy {
+  VePublishMode mode;                       // when to publish
+  int32_t deadband;                         // change of the typed value that is not published (>= 0), 0 for every change
+  uint32_t minInterval;                     // minimum clock ticks between two publications, 0 for none
+  uint32_t maxInterval;                     // publish again after clock ticks even if unchanged, 0 for never
+};
+
+/**
+ * @brief Publish policies of the known labels, evaluated once per committed frame
+ * @details Attach it with VeDirectFrameHandlerBase::setPublisher(). For every frame, the
+ *          received records of known labels are compared to the last published value (the
+ *          typed value with deadband) or to the text of the previous frame, a text change held
+ *          back by minInterval stays pending until it is published. Then the intervals are
+ *          checked. Only
+ *          the published records reach the label callbacks, getMask() selects them for the
+ *          serializers. Records of unknown labels are published when they changed since the
+ *          previous frame. The intervals need a clock, without one they are ignored.
+ */
+class VePublisher {
+  public:
+    VePublisher(veClockFunction clock = nullptr);
+
+    void setPolicy(VeLabel label, const VePublishPolicy& policy);
+    void setPolicy(const VePublishPolicy& policy);
+    void reset();
+
+    const uint32_t* getMask();              // VeLabelMask of the labels published by the last frame
+    bool isPublished(VeLabel label);
+
+    void evaluate(const VeDirectFrameHandlerBase::VeStore& front, const VeDirectFrameHandlerBase::VeStore& previous,
+                  const uint32_t* touched, uint32_t* published);
+
+  private:
+    veClockFunction mClock;                 // time source of the intervals, nullptr to ignore them
+    VePublishPolicy mPolicies[VE_LABEL_COUNT];
+    int32_t mLast[VE_LABEL_COUNT];          // last published typed value
+    uint32_t mLastTime[VE_LABEL_COUNT];     // clock at the last publication
+    VeLabelMask mSeen = { };                // labels published at least once
+    VeLabelMask mLastTyped = { };           // mLast holds a typed value
+    VeLabelMask mTextPending = { };         // text changed since the last publication
+    VeLabelMask mMask = { };                // labels published by the last frame
+
+    bool decide(uint8_t label, const VeDirectFrameHandlerBase::VeStore& front, const VeDirectFrameHandlerBase::VeStore& previous,
+                int slot, uint32_t now);
+};
+
+#endif // VEDIRECTPUBLISH_H_
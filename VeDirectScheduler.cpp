@@ -0,0 +1,180 @@
+/* VeDirectScheduler.cpp
+ *
+ * Learns when a device sends its TEXT frames, so the application can sleep in between.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ */
+
+#include "VeDirectScheduler.h"
+
+// VE.Direct Protocol: 19200 baud, 8N1 = 10 bits per byte
+#define SCHEDULER_BYTES_PER_SECOND 1920
+
+/**
+ * @brief Update a running average, the first samples are weighted more to converge fast
+ */
+static uint32_t average(uint32_t mean, uint32_t sample, uint8_t samples) {
+  int32_t weight = samples < 8 ? samples + 1 : 8;
+  return (int32_t)mean + ((int32_t)sample - (int32_t)mean) / weight;
+}
+
+/**
+ * @brief Time to receive bytes at 19200 baud
+ */
+uint32_t VeDirectScheduler::byteTime(uint32_t bytes) {
+  return (uint64_t)bytes * mTicksPerSecond / SCHEDULER_BYTES_PER_SECOND;
+}
+
+/**
+ * @brief Construct a new scheduler
+ *
+ * @param handler         Frame handler of the port, fed by rxData()
+ * @param clock           Time source, e.g. millis or micros on Arduino
+ * @param ticksPerSecond  Ticks of clock per second, e.g. 1000 for millis
+ * @param idleGap         Pause between two chunks that starts a new burst, 0 for 50ms
+ */
+VeDirectScheduler::VeDirectScheduler(VeDirectFrameHandlerBase& handler, veClockFunction clock, uint32_t ticksPerSecond, uint32_t idleGap)
+  : mHandler(handler), mClock(clock), mTicksPerSecond(ticksPerSecond), mIdleGap(idleGap ? idleGap : ticksPerSecond / 20) {
+  mFrame = handler.getSnapshot().frame;
+}
+
+/**
+ * @brief Feed a chunk of received bytes to the handler and measure its timing
+ * @details Call it with every chunk read from the port, as soon as it was read.
+ *
+ * @param buffer  Received bytes
+ * @param len     Number of bytes in buffer
+ */
+void VeDirectScheduler::rxData(const uint8_t* buffer, size_t len) {
+  if (!len) return;
+  uint32_t now = mClock();
+  if (!mReceiving || now - mLastByte > mIdleGap) {
+    burstEnd();
+    mBurstStart = now - byteTime(len);      // the chunk was on the line before it was read
+    mBurstBytes = 0;
+    mCommitBytes = 0;
+  }
+  mReceiving = true;
+  mLastByte = now;
+  mBurstBytes += len;
+
+  mHandler.rxData(buffer, len);
+  uint32_t frame = mHandler.getSnapshot().frame;
+  if (frame != mFrame) {
+    mFrame = frame;
+    frameCommitted();
+  }
+}
+
+/**
+ * @brief Forget the learned timing, e.g. after the device was replaced
+ */
+void VeDirectScheduler::reset() {
+  mReceiving = false;
+  mHaveStart = false;
+  mCommitBytes = 0;
+  mPeriod = 0;
+  mJitter = 0;
+  mFrameBytes = 0;
+  mSamples = 0;
+}
+
+/**
+ * @brief A burst is complete, average the position of its last checksum
+ */
+void VeDirectScheduler::burstEnd() {
+  if (!mCommitBytes) return;                // no valid frame in it, e.g. HEX messages only
+  mFrameBytes = mFrameBytes ? average(mFrameBytes, mCommitBytes, 7) : mCommitBytes;
+  mCommitBytes = 0;
+}
+
+/**
+ * @brief The current chunk completed a valid frame, average the period at the first one of the burst
+ */
+void VeDirectScheduler::frameCommitted() {
+  bool first = !mCommitBytes;
+  mCommitBytes = mBurstBytes;
+  if (!first) return;
+  if (mHaveStart) {
+    uint32_t interval = mBurstStart - mLastStart;
+    if (!mPeriod) {
+      mPeriod = interval;
+    } else {
+      uint32_t periods = (interval + mPeriod / 2) / mPeriod;
+      if (!periods) {                       // an additional burst between two frames
+        mCommitBytes = 0;
+        return;
+      }
+      uint32_t sample = interval / periods; // frames with checksum errors in between
+      uint32_t deviation = sample > mPeriod ? sample - mPeriod : mPeriod - sample;
+      mJitter = average(mJitter, deviation, mSamples - 1);
+      mPeriod = average(mPeriod, sample, mSamples);
+    }
+    if (mSamples < 255) mSamples++;
+  }
+  mLastStart = mBurstStart;
+  mHaveStart = true;
+}
+
+/**
+ * @brief Check if enough frames were received to predict the next one
+ */
+bool VeDirectScheduler::isLearned() {
+  return mSamples >= 3 && mPeriod && mFrameBytes;
+}
+
+uint32_t VeDirectScheduler::getPeriod() {
+  return mPeriod;
+}
+
+uint32_t VeDirectScheduler::getJitter() {
+  return mJitter;
+}
+
+uint32_t VeDirectScheduler::getFrameBytes() {
+  return mFrameBytes;
+}
+
+uint32_t VeDirectScheduler::getFrameTime() {
+  return byteTime(mFrameBytes);
+}
+
+/**
+ * @brief Time until the next frame is expected to start
+ * @details After missed frames, the next one is expected in the phase of the last received frame.
+ *
+ * @return uint32_t Ticks until the next frame, 0 if it is due or the timing is not learned yet
+ */
+uint32_t VeDirectScheduler::nextFrameIn() {
+  if (!isLearned()) return 0;
+  uint32_t elapsed = mClock() - mLastStart;
+  if (elapsed < mPeriod) return mPeriod - elapsed;
+  if (elapsed < mPeriod + mPeriod / 2) return 0;          // late, stay awake
+  return mPeriod - elapsed % mPeriod;
+}
+
+/**
+ * @brief Time the application can sleep without missing the start of the next frame
+ *
+ * @param wakeLatency Time the device needs to wake up and listen again
+ * @return uint32_t   Ticks to sleep, 0 to keep reading
+ */
+uint32_t VeDirectScheduler::sleepBudget(uint32_t wakeLatency) {
+  uint32_t next = nextFrameIn();
+  uint32_t margin = wakeLatency + 2 * mJitter;
+  return next > margin ? next - margin : 0;
+}
+
+/**
+ * @brief Time to wait after the first byte of a burst until all its frames were received
+ * @details Wake on the first byte, let the UART buffer fill for this time and feed everything
+ *          with a single rxData() call. The UART buffer must hold getFrameBytes() bytes.
+ *
+ * @return uint32_t Ticks to wait, 0 until the position of the checksum is learned
+ */
+uint32_t VeDirectScheduler::burstWait() {
+  uint32_t time = getFrameTime();
+  return time + time / 8;                   // margin for the baud rate tolerance
+}
@@ -0,0 +1,65 @@
+/* VeDirectScheduler.h
+ *
+ * Learns when a device sends its TEXT frames, so the application can sleep in between.
+ *
+ * 2026.10.14 - 0.1 - initial release
+ */
+
+#ifndef VEDIRECTSCHEDULER_H_
+#define VEDIRECTSCHEDULER_H_
+
+#include "VeDirectFrameHandler.h"
+
+/**
+ * @brief Frame timing of one VE.Direct port
+ * @details Feed the port through rxData() of the scheduler instead of the handler. Bytes that
+ *          follow each other closely form a burst, the bursts with a valid frame give the frame
+ *          period and the position of the last CHECKSUM record in the burst (in bytes from its
+ *          start). From that, nextFrameIn() and sleepBudget() tell how long the application can
+ *          sleep, and burstWait() how long to let the UART buffer fill after waking on the first
+ *          byte, to parse the whole burst with a single rxData() call.
+ *          All times are in ticks of the clock.
+ */
+class VeDirectScheduler {
+  public:
+    VeDirectScheduler(VeDirectFrameHandlerBase& handler, veClockFunction clock, uint32_t ticksPerSecond, uint32_t idleGap = 0);
+
+    void rxData(const uint8_t* buffer, size_t len);
+    void reset();
+
+    bool isLearned();
+    uint32_t getPeriod();                   // time between the start of two frames, 0 until learned
+    uint32_t getJitter();                   // mean deviation of the period
+    uint32_t getFrameBytes();               // bytes from the start of a burst up to its last checksum
+    uint32_t getFrameTime();                // time to receive getFrameBytes() at 19200 baud
+
+    uint32_t nextFrameIn();
+    uint32_t sleepBudget(uint32_t wakeLatency = 0);
+    uint32_t burstWait();
+
+  private:
+    VeDirectFrameHandlerBase& mHandler;     // port to feed
+    veClockFunction mClock;                 // time source
+    uint32_t mTicksPerSecond;               // ticks of mClock per second
+    uint32_t mIdleGap;                      // pause that separates two bursts
+
+    uint32_t mLastByte = 0;                 // clock at the last received chunk
+    uint32_t mBurstStart = 0;               // clock at the first chunk of the current burst
+    uint32_t mBurstBytes = 0;               // bytes received in the current burst
+    uint32_t mCommitBytes = 0;              // bytes of the current burst up to its last valid frame
+    uint32_t mFrame = 0;                    // frame counter of the handler after the last chunk
+    bool mReceiving = false;                // mLastByte is set
+    bool mHaveStart = false;                // mLastStart is set
+
+    uint32_t mLastStart = 0;                // start of the last burst with a valid frame
+    uint32_t mPeriod = 0;                   // averaged period, 0 until the first interval
+    uint32_t mJitter = 0;                   // averaged deviation of the period
+    uint32_t mFrameBytes = 0;               // averaged bytes of a burst up to its last checksum
+    uint8_t mSamples = 0;                   // number of periods measured, up to 255
+
+    uint32_t byteTime(uint32_t bytes);
+    void burstEnd();
+    void frameCommitted();
+};
+
+#endif // VEDIRECTSCHEDULER_H_
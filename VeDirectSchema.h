@@ -0,0 +1,166 @@
+/* VeDirectSchema.h
+ *
+ * Compile-time label sets of the Victron product families, detection of the family by PID.
+ * Label sets based on the VE.Direct Protocol version 3.33.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - load() from the per slot typed values of a store
+ */
+
+#ifndef VEDIRECTSCHEMA_H_
+#define VEDIRECTSCHEMA_H_
+
+#include "VeDirectFrameHandler.h"
+
+enum VeProduct : uint8_t {
+  VE_PRODUCT_UNKNOWN,
+  VE_PRODUCT_BMV,                             // BMV-700, BMV-702, BMV-712 battery monitors
+  VE_PRODUCT_SMARTSHUNT,                      // SmartShunt battery monitors
+  VE_PRODUCT_MPPT,                            // BlueSolar and SmartSolar MPPT charge controllers
+  VE_PRODUCT_PHOENIX                          // Phoenix inverters
+};
+
+/**
+ * @brief Product family of a product id, the value of the PID label
+ */
+constexpr VeProduct veProductFromPid(uint32_t pid) {
+  return (pid >= 0x0203 && pid <= 0x0205) || (pid >= 0xA381 && pid <= 0xA383) ? VE_PRODUCT_BMV
+       : pid >= 0xA389 && pid <= 0xA38B ? VE_PRODUCT_SMARTSHUNT
+       : pid == 0x0300 || (pid >= 0xA040 && pid <= 0xA1FF) ? VE_PRODUCT_MPPT
+       : pid >= 0xA200 && pid <= 0xA2FF ? VE_PRODUCT_PHOENIX
+       : VE_PRODUCT_UNKNOWN;
+}
+
+/**
+ * @brief Product family of the device connected to a handler, detected from the PID record
+ *
+ * @return VeProduct  VE_PRODUCT_UNKNOWN until a frame with PID was received
+ */
+inline VeProduct veDetectProduct(VeDirectFrameHandlerBase& handler) {
+  int32_t pid;
+  return handler.getTyped(VE_LABEL_PID, pid) ? veProductFromPid(pid) : VE_PRODUCT_UNKNOWN;
+}
+
+/**
+ * @brief Fixed label set of a product family
+ * @details All members are constexpr: index() of a label known at compile time is a constant,
+ *          so VeSchemaValues reads its values without any lookup.
+ */
+template <VeProduct Product, VeLabel... Labels>
+struct VeSchema {
+  static constexpr VeProduct product = Product;
+  static constexpr uint8_t count = sizeof...(Labels);
+  static constexpr VeLabel labels[count] = { Labels... };
+
+  /**
+   * @brief Position of a label in the schema, -1 if the product does not send it
+   */
+  static constexpr int index(VeLabel label) {
+    for (int i = 0; i < count; i++) {
+      if (labels[i] == label) return i;
+    }
+    return -1;
+  }
+  static constexpr bool contains(VeLabel label) { return index(label) >= 0; }
+  static constexpr bool matches(uint32_t pid) { return veProductFromPid(pid) == Product; }
+};
+
+typedef VeSchema<VE_PRODUCT_BMV,
+  VE_LABEL_PID, VE_LABEL_V, VE_LABEL_VS, VE_LABEL_VM, VE_LABEL_DM, VE_LABEL_I, VE_LABEL_T, VE_LABEL_P,
+  VE_LABEL_CE, VE_LABEL_SOC, VE_LABEL_TTG, VE_LABEL_ALARM, VE_LABEL_RELAY, VE_LABEL_AR, VE_LABEL_BMV,
+  VE_LABEL_FW, VE_LABEL_MON, VE_LABEL_H1, VE_LABEL_H2, VE_LABEL_H3, VE_LABEL_H4, VE_LABEL_H5, VE_LABEL_H6,
+  VE_LABEL_H7, VE_LABEL_H8, VE_LABEL_H9, VE_LABEL_H10, VE_LABEL_H11, VE_LABEL_H12, VE_LABEL_H13,
+  VE_LABEL_H14, VE_LABEL_H15, VE_LABEL_H16, VE_LABEL_H17, VE_LABEL_H18> VeSchemaBmv;
+
+typedef VeSchema<VE_PRODUCT_SMARTSHUNT,
+  VE_LABEL_PID, VE_LABEL_V, VE_LABEL_VS, VE_LABEL_VM, VE_LABEL_DM, VE_LABEL_I, VE_LABEL_T, VE_LABEL_P,
+  VE_LABEL_CE, VE_LABEL_SOC, VE_LABEL_TTG, VE_LABEL_ALARM, VE_LABEL_AR, VE_LABEL_BMV, VE_LABEL_FW,
+  VE_LABEL_MON, VE_LABEL_H1, VE_LABEL_H2, VE_LABEL_H3, VE_LABEL_H4, VE_LABEL_H5, VE_LABEL_H6, VE_LABEL_H7,
+  VE_LABEL_H8, VE_LABEL_H9, VE_LABEL_H10, VE_LABEL_H11, VE_LABEL_H12, VE_LABEL_H13, VE_LABEL_H14,
+  VE_LABEL_H15, VE_LABEL_H16, VE_LABEL_H17, VE_LABEL_H18> VeSchemaSmartShunt;
+
+typedef VeSchema<VE_PRODUCT_MPPT,
+  VE_LABEL_PID, VE_LABEL_FW, VE_LABEL_SER, VE_LABEL_V, VE_LABEL_I, VE_LABEL_VPV, VE_LABEL_PPV, VE_LABEL_CS,
+  VE_LABEL_MPPT, VE_LABEL_OR, VE_LABEL_ERR, VE_LABEL_LOAD, VE_LABEL_IL, VE_LABEL_H19, VE_LABEL_H20,
+  VE_LABEL_H21, VE_LABEL_H22, VE_LABEL_H23, VE_LABEL_HSDS> VeSchemaMppt;
+
+typedef VeSchema<VE_PRODUCT_PHOENIX,
+  VE_LABEL_PID, VE_LABEL_FW, VE_LABEL_SER, VE_LABEL_MODE, VE_LABEL_CS, VE_LABEL_AC_OUT_V, VE_LABEL_AC_OUT_I,
+  VE_LABEL_AC_OUT_S, VE_LABEL_V, VE_LABEL_AR, VE_LABEL_WARN, VE_LABEL_OR> VeSchemaPhoenix;
+
+/**
+ * @brief Frame handler sized for one product family
+ * @details Spare slots keep labels that are not part of the schema, e.g. from a newer firmware.
+ */
+template <typename Schema, uint8_t Spare = 2>
+using VeDirectFrameHandlerFor = VeDirectFrameHandlerT<Schema::count + Spare, frameLen, hexBuffLen>;
+
+/**
+ * @brief Typed values of one product family, sized for its labels only
+ * @details load() copies them out of the store of a handler or a copy of its typed values,
+ *          get<Label>() is a direct member access, using a label the product does not send fails
+ *          to compile.
+ *
+ * @code
+ * VeSchemaValues<VeSchemaMppt> mppt;
+ * if (mppt.load(handler.getSnapshot()) && mppt.has<VE_LABEL_PPV>()) printf("%d W\n", mppt.get<VE_LABEL_PPV>());
+ * @endcode
+ */
+template <typename Schema>
+struct VeSchemaValues {
+  int32_t value[Schema::count];               // parsed value of each label of the schema, in schema order
+  uint32_t valid[(Schema::count + 31) / 32];  // bit set if the label has a valid value
+
+  /**
+   * @brief Copy the values of the schema labels
+   *
+   * @param store   Store of a handler, e.g. getSnapshot()
+   * @return true   if at least one label of the schema has a valid value
+   */
+  bool load(const VeDirectFrameHandlerBase::VeStore& store) {
+    bool any = false;
+    for (uint32_t& bits : valid) bits = 0;
+    for (int i = 0; i < Schema::count; i++) {
+      value[i] = 0;
+      if (store.getTyped(Schema::labels[i], value[i])) {
+        valid[i / 32] |= 1u << (i % 32);
+        any = true;
+      }
+    }
+    return any;
+  }
+
+  /**
+   * @brief Same as above, from a copy of the typed values, e.g. Snapshot::typed
+   */
+  bool load(const VeDirectFrameHandlerBase::VeTypedData& typed) {
+    bool any = false;
+    for (uint32_t& bits : valid) bits = 0;
+    for (int i = 0; i < Schema::count; i++) {
+      uint8_t label = Schema::labels[i];
+      value[i] = typed.value[label];
+      if (typed.valid[label / 32] & (1u << (label % 32))) {
+        valid[i / 32] |= 1u << (i % 32);
+        any = true;
+      }
+    }
+    return any;
+  }
+
+  template <VeLabel Label>
+  bool has() const {
+    static_assert(Schema::contains(Label), "label is not part of the schema");
+    constexpr int i = Schema::index(Label);
+    return valid[i / 32] & (1u << (i % 32));
+  }
+
+  template <VeLabel Label>
+  int32_t get() const {
+    static_assert(Schema::contains(Label), "label is not part of the schema");
+    return value[Schema::index(Label)];
+  }
+};
+
+#endif // VEDIRECTSCHEMA_H_
@@ -0,0 +1,262 @@
+/* VeDirectSerializer.cpp
+ *
+ * Writes a snapshot of the frame store as JSON, InfluxDB line protocol or CBOR into a caller buffer.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - Influx skips the unparsable values of numeric labels
+ */
+
+#include <string.h>
+
+#include "VeDirectSerializer.h"
+
+/**
+ * @brief Bounded writer into the caller buffer, remembers if anything did not fit
+ */
+struct VeWriter {
+  uint8_t* pos;
+  uint8_t* end;
+  bool overflow;
+
+  VeWriter(void* buffer, size_t size) : pos((uint8_t*)buffer), end((uint8_t*)buffer + size), overflow(false) {}
+
+  void put(uint8_t c) {
+    if (pos < end) *pos++ = c;
+    else overflow = true;
+  }
+  void put(const void* data, size_t len) {
+    if ((size_t)(end - pos) < len) {
+      overflow = true;
+      pos = end;
+      return;
+    }
+    memcpy(pos, data, len);
+    pos += len;
+  }
+  void put(const char* text) {
+    put(text, strlen(text));
+  }
+  // decimal integer without printf
+  void putInt(int64_t value) {
+    char digits[20];
+    int n = 0;
+    uint64_t u = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+    do {
+      digits[n++] = '0' + u % 10;
+      u /= 10;
+    } while (u);
+    if (value < 0) put('-');
+    while (n) put(digits[--n]);
+  }
+};
+
+/**
+ * @brief One entry of the snapshot that should be written
+ */
+struct VeEntry {
+  const char* name;
+  const char* text;                         // value as received
+  uint8_t label;                            // label id or VE_LABEL_UNKNOWN
+  bool typed;                               // value holds the parsed value
+  int32_t value;
+};
+
+/**
+ * @brief Select the entry of a slot, skips the checksum and labels excluded by the mask
+ *
+ * @return true if the slot should be written
+ */
+static bool entry(const VeDirectFrameHandlerBase::VeStore& snapshot, int slot, const uint32_t* mask, VeEntry& e) {
+  e.label = snapshot.slotLabel[slot];
+  if (e.label == VE_LABEL_CHECKSUM) return false;
+  if (mask && (e.label >= VE_LABEL_COUNT || !(mask[e.label / 32] & (1u << (e.label % 32))))) return false;
+  e.name = snapshot.data[slot].veName;
+  e.text = snapshot.data[slot].veValue;
+  e.typed = e.label < VE_LABEL_COUNT && snapshot.isTyped(slot);
+  e.value = e.typed ? snapshot.typedValue[slot] : 0;
+  return true;
+}
+
+static bool isOnOff(const VeEntry& e) {
+  return e.typed && veLabels[e.label].type == VE_TYPE_ONOFF;
+}
+
+/**
+ * @brief Write text as JSON string content, escaping quotes, backslashes and control characters
+ */
+static void putJsonText(VeWriter& w, const char* text) {
+  static const char hex[] = "0123456789abcdef";
+  for (const uint8_t* p = (const uint8_t*)text; *p; p++) {
+    if (*p == '"' || *p == '\\') {
+      w.put('\\');
+      w.put(*p);
+    } else if (*p < 0x20) {
+      w.put("\\u00", 4);
+      w.put(hex[*p >> 4]);
+      w.put(hex[*p & 15]);
+    } else w.put(*p);
+  }
+}
+
+/**
+ * @brief Write text for the line protocol, escaping the characters listed in escape
+ */
+static void putInfluxText(VeWriter& w, const char* text, const char* escape) {
+  for (const char* p = text; *p; p++) {
+    if (strchr(escape, *p)) w.put('\\');
+    w.put(*p);
+  }
+}
+
+/**
+ * @brief Write the snapshot as a JSON object
+ * @details Parsed values are written as numbers (ON/OFF as true/false), strings and values that
+ *          can't be parsed as strings, e.g. {"V":13790,"LOAD":true,"SER#":"HQ2132ABCDE"}.
+ *          The names of the known labels never need escaping, only unknown names are escaped.
+ *
+ * @param snapshot  Frame store, e.g. getSnapshot()
+ * @param buffer    Output, zero terminated
+ * @param size      Size of buffer
+ * @param mask      Label ids to write or nullptr for all labels including unknown ones
+ * @return int      Length without the zero or -1 if buffer is too small
+ */
+int veSerializeJson(const VeDirectFrameHandlerBase::VeStore& snapshot, char* buffer, size_t size, const uint32_t* mask) {
+  VeWriter w(buffer, size);
+  w.put('{');
+  bool first = true;
+  for (int slot = 0; slot < snapshot.end; slot++) {
+    VeEntry e;
+    if (!entry(snapshot, slot, mask, e)) continue;
+    if (!first) w.put(',');
+    first = false;
+    w.put('"');
+    if (e.label < VE_LABEL_COUNT) w.put(veLabels[e.label].name);
+    else putJsonText(w, e.name);
+    w.put("\":", 2);
+    if (isOnOff(e)) w.put(e.value ? "true" : "false");
+    else if (e.typed) w.putInt(e.value);
+    else {
+      w.put('"');
+      putJsonText(w, e.text);
+      w.put('"');
+    }
+  }
+  w.put('}');
+  w.put('\0');
+  return w.overflow ? -1 : (int)(w.pos - (uint8_t*)buffer) - 1;
+}
+
+/**
+ * @brief Write the snapshot as one line of the InfluxDB line protocol
+ * @details Parsed values become integer fields (ON/OFF boolean), strings become string fields:
+ *          measurement[,tags] V=13790i,LOAD=true,SER#="HQ2132ABCDE" [timestamp]
+ *          A field keeps its type in InfluxDB, so a value of a numeric label that can't be
+ *          parsed (e.g. "---") is skipped instead of written as string.
+ *
+ * @param snapshot    Frame store, e.g. getSnapshot()
+ * @param measurement Name of the measurement, escaped by the caller
+ * @param tags        Tags without the leading comma, escaped by the caller, or nullptr
+ * @param timestamp   Timestamp in the precision of the database or 0 to let the server set it
+ * @param buffer      Output, terminated with \n and zero
+ * @param size        Size of buffer
+ * @param mask        Label ids to write or nullptr for all labels including unknown ones
+ * @return int        Length without the zero, -1 if buffer is too small, 0 if there are no fields
+ */
+int veSerializeInflux(const VeDirectFrameHandlerBase::VeStore& snapshot, const char* measurement, const char* tags,
+                      uint64_t timestamp, char* buffer, size_t size, const uint32_t* mask) {
+  VeWriter w(buffer, size);
+  w.put(measurement);
+  if (tags && *tags) {
+    w.put(',');
+    w.put(tags);
+  }
+  bool first = true;
+  for (int slot = 0; slot < snapshot.end; slot++) {
+    VeEntry e;
+    if (!entry(snapshot, slot, mask, e)) continue;
+    if (!e.typed && e.label < VE_LABEL_COUNT && veLabels[e.label].type != VE_TYPE_STRING) continue;
+    w.put(first ? ' ' : ',');
+    first = false;
+    if (e.label < VE_LABEL_COUNT) w.put(veLabels[e.label].name);
+    else putInfluxText(w, e.name, ",= ");
+    w.put('=');
+    if (isOnOff(e)) w.put(e.value ? "true" : "false");
+    else if (e.typed) {
+      w.putInt(e.value);
+      w.put('i');
+    } else {
+      w.put('"');
+      putInfluxText(w, e.text, "\"\\");
+      w.put('"');
+    }
+  }
+  if (first) {                             // a line without fields is not valid
+    if (size) buffer[0] = 0;
+    return 0;
+  }
+  if (timestamp) {
+    w.put(' ');
+    w.putInt((int64_t)timestamp);
+  }
+  w.put('\n');
+  w.put('\0');
+  return w.overflow ? -1 : (int)(w.pos - (uint8_t*)buffer) - 1;
+}
+
+/**
+ * @brief Write a CBOR head (major type and argument)
+ */
+static void putCborHead(VeWriter& w, uint8_t major, uint64_t value) {
+  major <<= 5;
+  if (value < 24) w.put(major | (uint8_t)value);
+  else if (value <= 0xFF) {
+    w.put(major | 24);
+    w.put((uint8_t)value);
+  } else if (value <= 0xFFFF) {
+    w.put(major | 25);
+    w.put((uint8_t)(value >> 8));
+    w.put((uint8_t)value);
+  } else {
+    w.put(major | 26);
+    for (int shift = 24; shift >= 0; shift -= 8) w.put((uint8_t)(value >> shift));
+  }
+}
+
+static void putCborText(VeWriter& w, const char* text) {
+  size_t len = strlen(text);
+  putCborHead(w, 3, len);
+  w.put(text, len);
+}
+
+/**
+ * @brief Write the snapshot as a CBOR map
+ * @details Keys are the label names, parsed values are integers (ON/OFF true/false), strings
+ *          and values that can't be parsed are text strings.
+ *
+ * @param snapshot  Frame store, e.g. getSnapshot()
+ * @param buffer    Output
+ * @param size      Size of buffer
+ * @param mask      Label ids to write or nullptr for all labels including unknown ones
+ * @return int      Length or -1 if buffer is too small
+ */
+int veSerializeCbor(const VeDirectFrameHandlerBase::VeStore& snapshot, uint8_t* buffer, size_t size, const uint32_t* mask) {
+  VeWriter w(buffer, size);
+  int count = 0;
+  for (int slot = 0; slot < snapshot.end; slot++) {
+    VeEntry e;
+    if (entry(snapshot, slot, mask, e)) count++;
+  }
+  putCborHead(w, 5, count);
+  for (int slot = 0; slot < snapshot.end; slot++) {
+    VeEntry e;
+    if (!entry(snapshot, slot, mask, e)) continue;
+    putCborText(w, e.label < VE_LABEL_COUNT ? veLabels[e.label].name : e.name);
+    if (isOnOff(e)) w.put(e.value ? 0xF5 : 0xF4);
+    else if (e.typed && e.value >= 0) putCborHead(w, 0, (uint64_t)e.value);
+    else if (e.typed) putCborHead(w, 1, (uint64_t)(-1 - (int64_t)e.value));
+    else putCborText(w, e.text);
+  }
+  return w.overflow ? -1 : (int)(w.pos - buffer);
+}
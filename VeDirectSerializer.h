@@ -0,0 +1,21 @@
+/* VeDirectSerializer.h
+ *
+ * Writes a snapshot of the frame store as JSON, InfluxDB line protocol or CBOR into a caller buffer.
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - Influx skips the unparsable values of numeric labels
+ */
+
+#ifndef VEDIRECTSERIALIZER_H_
+#define VEDIRECTSERIALIZER_H_
+
+#include "VeDirectFrameHandler.h"
+
+int veSerializeJson(const VeDirectFrameHandlerBase::VeStore& snapshot, char* buffer, size_t size,
+                    const uint32_t* mask = nullptr);
+int veSerializeInflux(const VeDirectFrameHandlerBase::VeStore& snapshot, const char* measurement, const char* tags,
+                      uint64_t timestamp, char* buffer, size_t size, const uint32_t* mask = nullptr);
+int veSerializeCbor(const VeDirectFrameHandlerBase::VeStore& snapshot, uint8_t* buffer, size_t size,
+                    const uint32_t* mask = nullptr);
+
+#endif // VEDIRECTSERIALIZER_H_
@@ -0,0 +1,254 @@
+/* VeDirectShm.cpp
+ *
+ * Publishes the last valid frame into POSIX shared memory for readers in other processes.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ */
+
+#if defined(__linux__)
+
+#include "VeDirectShm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// attempts of read to get a copy without an update in between
+#define SHM_READ_RETRIES 4
+
+/**
+ * @brief Size of a segment with maxLabels records
+ */
+static size_t segmentSize(uint16_t maxLabels) {
+  return sizeof(VeShmHeader) + maxLabels * sizeof(VeShmRecord);
+}
+
+/**
+ * @brief Destroy the writer, the segment stays until remove()
+ */
+VeDirectShmWriter::~VeDirectShmWriter() {
+  close();
+}
+
+/**
+ * @brief Create or open a shared memory segment and map it for writing
+ * @details An existing segment with the same layout keeps its sequence, so readers that have it
+ *          mapped continue to work after a restart of the writer.
+ *
+ * @param name      Name of the segment, starting with '/', e.g. "/vedirect-mppt"
+ * @param maxLabels Number of records, labels beyond are not published
+ * @return int      0 or -1
+ */
+int VeDirectShmWriter::open(const char* name, uint16_t maxLabels) {
+  close();
+  int fd = shm_open(name, O_CREAT | O_RDWR | O_CLOEXEC, 0644);
+  if (fd < 0) return -1;
+  size_t size = segmentSize(maxLabels);
+  struct stat st;
+  bool reuse = fstat(fd, &st) == 0 && (size_t)st.st_size == size;
+  if (!reuse && ftruncate(fd, size) < 0) {
+    int err = errno;
+    ::close(fd);
+    errno = err;
+    return -1;
+  }
+  void* map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) return -1;
+
+  mHeader = static_cast<VeShmHeader*>(map);
+  mSize = size;
+  reuse = reuse && mHeader->magic == VEDIRECT_SHM_MAGIC && mHeader->version == VEDIRECT_SHM_VERSION && mHeader->maxLabels == maxLabels;
+  if (reuse) {
+    uint32_t sequence = mHeader->sequence.load(std::memory_order_relaxed);
+    if (sequence & 1) mHeader->sequence.store(sequence + 1, std::memory_order_release); // previous writer died while writing
+  } else {
+    memset((void*)mHeader, 0, size);
+    mHeader->version = VEDIRECT_SHM_VERSION;
+    mHeader->maxLabels = maxLabels;
+    std::atomic_thread_fence(std::memory_order_release);
+    mHeader->magic = VEDIRECT_SHM_MAGIC;
+  }
+  return 0;
+}
+
+/**
+ * @brief Publish every valid frame of a handler
+ *
+ * @param handler   Handler to publish, the segment must be open
+ * @return int      Result of addFrameCallback, -1 if there is no free frame callback
+ */
+int VeDirectShmWriter::attach(VeDirectFrameHandlerBase& handler) {
+  return handler.addFrameCallback(frameEvent, this);
+}
+
+/**
+ * @brief Publish the new frame of a handler
+ *
+ * @param handler   Frame handler that received the frame
+ * @param writer    VeDirectShmWriter to publish with
+ */
+void VeDirectShmWriter::frameEvent(VeDirectFrameHandlerBase& handler, void* writer) {
+  static_cast<VeDirectShmWriter*>(writer)->publish(handler.getSnapshot());
+}
+
+/**
+ * @brief Copy a snapshot into the segment
+ * @details The sequence is odd during the copy, readers retry until it is even and unchanged.
+ *
+ * @param store     Snapshot to publish, e.g. getSnapshot() of a handler
+ */
+void VeDirectShmWriter::publish(const VeDirectFrameHandlerBase::VeStore& store) {
+  if (!mHeader) return;
+  uint32_t sequence = mHeader->sequence.load(std::memory_order_relaxed);
+  mHeader->sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);      // keep the writes below behind the odd sequence
+
+  uint32_t end = store.end < mHeader->maxLabels ? store.end : mHeader->maxLabels;
+  VeShmRecord* records = reinterpret_cast<VeShmRecord*>(mHeader + 1);
+  for (uint32_t i = 0; i < end; i++) {
+    memcpy(records[i].name, store.data[i].veName, nameLen);
+    memcpy(records[i].value, store.data[i].veValue, valueLen);
+    records[i].label = store.slotLabel[i];
+    records[i].flags = (store.unverified[i / 32] & (1u << (i % 32))) ? VE_SHM_UNVERIFIED : 0;
+  }
+  mHeader->frame = store.frame;
+  mHeader->end = end;
+  VeDirectFrameHandlerBase::VeTypedData typed;
+  store.copyTyped(typed);
+  memcpy(mHeader->typedValid, typed.valid, sizeof(mHeader->typedValid));
+  memcpy(mHeader->typedValue, typed.value, sizeof(mHeader->typedValue));
+
+  mHeader->sequence.store(sequence + 2, std::memory_order_release);
+}
+
+/**
+ * @brief Unmap the segment
+ */
+void VeDirectShmWriter::close() {
+  if (mHeader) munmap((void*)mHeader, mSize);
+  mHeader = nullptr;
+}
+
+/**
+ * @brief Remove a segment, readers that have it mapped keep their mapping
+ *
+ * @param name      Name of the segment
+ * @return int      0 or -1
+ */
+int VeDirectShmWriter::remove(const char* name) {
+  return shm_unlink(name);
+}
+
+/**
+ * @brief Destroy the reader
+ */
+VeDirectShmReader::~VeDirectShmReader() {
+  close();
+}
+
+/**
+ * @brief Map an existing segment read only
+ *
+ * @param name      Name of the segment
+ * @return int      0 or -1, errno is EPROTO if the segment has an unknown layout
+ */
+int VeDirectShmReader::open(const char* name) {
+  close();
+  int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+  if (fd < 0) return -1;
+  struct stat st;
+  if (fstat(fd, &st) < 0) {
+    int err = errno;
+    ::close(fd);
+    errno = err;
+    return -1;
+  }
+  size_t size = st.st_size;
+  void* map = size >= sizeof(VeShmHeader) ? mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    if (size < sizeof(VeShmHeader)) errno = EPROTO;
+    return -1;
+  }
+  const VeShmHeader* header = static_cast<const VeShmHeader*>(map);
+  if (header->magic != VEDIRECT_SHM_MAGIC || header->version != VEDIRECT_SHM_VERSION || size < segmentSize(header->maxLabels)) {
+    munmap(map, size);
+    errno = EPROTO;
+    return -1;
+  }
+  mHeader = header;
+  mSize = size;
+  return 0;
+}
+
+/**
+ * @brief Unmap the segment
+ */
+void VeDirectShmReader::close() {
+  if (mHeader) munmap((void*)mHeader, mSize);
+  mHeader = nullptr;
+}
+
+/**
+ * @brief Start reading the segment in place
+ *
+ * @return uint32_t Sequence to pass to readRetry
+ */
+uint32_t VeDirectShmReader::readBegin() {
+  return mHeader->sequence.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Check if the data read since readBegin may be inconsistent
+ *
+ * @param sequence  Result of readBegin
+ * @return true     if the writer updated the segment meanwhile, read again
+ * @return false    if the data read is a consistent snapshot
+ */
+bool VeDirectShmReader::readRetry(uint32_t sequence) {
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return (sequence & 1) || mHeader->sequence.load(std::memory_order_relaxed) != sequence;
+}
+
+/**
+ * @brief Copy the last published frame, same as VeDirectFrameHandlerBase::readSnapshot
+ *
+ * @param data      Buffer for the name/value pairs
+ * @param maxLabels Size of data
+ * @param end       Number of records copied to data
+ * @param typed     Optional buffer for the typed values
+ * @param frame     Optional number of frames committed up to this snapshot
+ * @return true     if a consistent copy was made
+ * @return false    if the segment is not open or was updated during every attempt
+ */
+bool VeDirectShmReader::read(VeDirectFrameHandlerBase::VeData* data, uint8_t maxLabels, int& end,
+                             VeDirectFrameHandlerBase::VeTypedData* typed, uint32_t* frame) {
+  if (!mHeader) return false;
+  const VeShmRecord* shared = records();
+  for (int attempt = 0; attempt < SHM_READ_RETRIES; attempt++) {
+    uint32_t sequence = readBegin();
+    if (sequence & 1) continue;
+    end = mHeader->end;
+    if (end > mHeader->maxLabels) end = mHeader->maxLabels;   // torn read, retried below
+    if (end > maxLabels) end = maxLabels;
+    for (int i = 0; i < end; i++) {
+      memcpy(data[i].veName, shared[i].name, nameLen);
+      memcpy(data[i].veValue, shared[i].value, valueLen);
+    }
+    if (typed) {
+      memcpy(typed->valid, mHeader->typedValid, sizeof(typed->valid));
+      memcpy(typed->value, mHeader->typedValue, sizeof(typed->value));
+    }
+    if (frame) *frame = mHeader->frame;
+    if (!readRetry(sequence)) return true;
+  }
+  return false;
+}
+
+#endif // __linux__
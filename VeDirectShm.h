@@ -0,0 +1,108 @@
+/* VeDirectShm.h
+ *
+ * Publishes the last valid frame into POSIX shared memory for readers in other processes.
+ *
+ * 2026.10.14 - 0.1 - initial release
+ */
+
+#ifndef VEDIRECTSHM_H_
+#define VEDIRECTSHM_H_
+
+#if defined(__linux__)
+
+#include <atomic>
+
+#include "VeDirectFrameHandler.h"
+
+#define VEDIRECT_SHM_MAGIC 0x53444556u      // "VEDS" in memory
+#define VEDIRECT_SHM_VERSION 1              // increased with every change of the layout
+
+enum VeShmFlags : uint8_t {                 // flags of a VeShmRecord
+  VE_SHM_UNVERIFIED = 0x01                  // accepted from a frame with an invalid checksum, see partialAccept
+};
+
+/**
+ * @brief Header of the shared memory segment, followed by maxLabels VeShmRecord
+ * @details The layout is fixed (native byte order), readers in any language can map it.
+ *          The writer increments sequence before and after each update, a reader copies
+ *          the data when sequence is even and accepts it if sequence did not change meanwhile.
+ */
+struct VeShmHeader {
+  uint32_t magic;                           // VEDIRECT_SHM_MAGIC
+  uint16_t version;                         // VEDIRECT_SHM_VERSION
+  uint16_t maxLabels;                       // number of records following the header
+  std::atomic<uint32_t> sequence;           // odd while the writer updates the segment
+  uint32_t frame;                           // number of frames committed up to this snapshot
+  uint32_t end;                             // number of used records
+  uint32_t typedValid[2];                   // bit set if the label (VeLabel) has a typed value
+  int32_t typedValue[VE_LABEL_COUNT];       // parsed value of each known label, unit see VeLabel
+};
+
+struct VeShmRecord {
+  char name[nameLen];                       // label name, zero terminated
+  char value[valueLen];                     // value as received, zero terminated
+  uint8_t label;                            // VeLabel or VE_LABEL_UNKNOWN
+  uint8_t flags;                            // see VeShmFlags
+};
+
+static_assert(VE_LABEL_COUNT == 64 && nameLen == 9 && valueLen == 33, "layout changed, increase VEDIRECT_SHM_VERSION");
+static_assert(sizeof(VeShmHeader) == 284 && sizeof(VeShmRecord) == 44, "unexpected padding in the shared memory layout");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "the sequence must be lock free to be shared between processes");
+
+/**
+ * @brief Writer of the shared memory segment
+ * @details attach() publishes every valid frame of a handler, or call publish() directly.
+ *          Functions that fail return -1 and leave the reason in errno.
+ */
+class VeDirectShmWriter {
+  public:
+    VeDirectShmWriter() = default;
+    ~VeDirectShmWriter();
+    VeDirectShmWriter(const VeDirectShmWriter&) = delete;
+    VeDirectShmWriter& operator=(const VeDirectShmWriter&) = delete;
+
+    int open(const char* name, uint16_t maxLabels = buffLen);
+    int attach(VeDirectFrameHandlerBase& handler);
+    void publish(const VeDirectFrameHandlerBase::VeStore& store);
+    void close();
+
+    static int remove(const char* name);
+
+  private:
+    VeShmHeader* mHeader = nullptr;         // mapped segment, nullptr if not open
+    size_t mSize = 0;                       // size of the mapping
+
+    static void frameEvent(VeDirectFrameHandlerBase& handler, void* writer);
+};
+
+/**
+ * @brief Reader of the shared memory segment, any number of them in any process
+ * @details Without copying: take readBegin(), read header() and records(), and use the values
+ *          only if readRetry() returns false. read() does that with a copy. Reading never
+ *          blocks the writer and needs no system calls.
+ */
+class VeDirectShmReader {
+  public:
+    VeDirectShmReader() = default;
+    ~VeDirectShmReader();
+    VeDirectShmReader(const VeDirectShmReader&) = delete;
+    VeDirectShmReader& operator=(const VeDirectShmReader&) = delete;
+
+    int open(const char* name);
+    void close();
+
+    const VeShmHeader* header() { return mHeader; }
+    const VeShmRecord* records() { return reinterpret_cast<const VeShmRecord*>(mHeader + 1); }
+    uint32_t readBegin();
+    bool readRetry(uint32_t sequence);
+    bool read(VeDirectFrameHandlerBase::VeData* data, uint8_t maxLabels, int& end,
+              VeDirectFrameHandlerBase::VeTypedData* typed = nullptr, uint32_t* frame = nullptr);
+
+  private:
+    const VeShmHeader* mHeader = nullptr;   // mapped segment, nullptr if not open
+    size_t mSize = 0;                       // size of the mapping
+};
+
+#endif // __linux__
+
+#endif // VEDIRECTSHM_H_
@@ -0,0 +1,165 @@
+/* vedirect_bench.cpp
+ *
+ * Replays VE.Direct captures through the frame handler and reports the speed of the parser.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - a new handler for each run, no state carried over from the previous capture
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "VeDirectFrameHandler.h"
+
+#ifndef VEDIRECT_CAPTURES
+#define VEDIRECT_CAPTURES "captures"
+#endif
+
+static const char* defaultCaptures[] = { "bmv712.vd", "mppt.vd", "phoenix.vd" };
+
+// count the heap allocations of the library, the handler should not allocate while parsing
+static size_t allocations = 0;
+
+void* operator new(size_t size) {
+  allocations++;
+  void* p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+/**
+ * @brief Read a whole capture file
+ *
+ * @param path  File name
+ * @param data  File content
+ * @return true if the file could be read
+ */
+static bool readCapture(const std::string& path, std::vector<uint8_t>& data) {
+  FILE* fp = fopen(path.c_str(), "rb");
+  if (!fp) return false;
+  uint8_t buffer[4096];
+  size_t len;
+  while ((len = fread(buffer, 1, sizeof(buffer), fp)) > 0) data.insert(data.end(), buffer, buffer + len);
+  fclose(fp);
+  return !data.empty();
+}
+
+/**
+ * @brief Copy a capture with line noise, as seen on long or badly shielded cables
+ * @details About rate of the bytes are replaced by a random byte, replaced by ':' (starts a bogus
+ *          HEX frame) or dropped. The same seed always gives the same stream.
+ *
+ * @param data  Clean capture
+ * @param rate  Probability of a corrupted byte
+ * @return std::vector<uint8_t> Corrupted capture
+ */
+static std::vector<uint8_t> corrupt(const std::vector<uint8_t>& data, double rate) {
+  std::vector<uint8_t> out;
+  out.reserve(data.size());
+  uint32_t seed = 0x2545F491;
+  uint32_t limit = (uint32_t)(rate * 0xFFFFFFFFu);
+  for (uint8_t b : data) {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    if (seed >= limit) out.push_back(b);
+    else if (seed % 3 == 0) out.push_back((uint8_t)(seed >> 8));
+    else if (seed % 3 == 1) out.push_back(':');
+  }
+  return out;
+}
+
+struct Result {
+  double nsPerByte;
+  double framesPerSecond;
+  uint32_t frames;
+  size_t allocations;
+};
+
+/**
+ * @brief Feed a capture to a new handler until minMs passed
+ *
+ * @param data  Capture
+ * @param chunk Bytes per rxData call, 0 for the byte-wise rxData
+ * @param minMs Minimum run time
+ * @return Result
+ */
+static Result run(const std::vector<uint8_t>& data, size_t chunk, int minMs) {
+  VeDirectFrameHandler handler;
+  size_t before = allocations;
+  size_t bytes = 0;
+  auto start = std::chrono::steady_clock::now();
+  double elapsed = 0;
+  do {
+    const uint8_t* p = data.data();
+    const uint8_t* end = p + data.size();
+    if (chunk == 0) {
+      while (p < end) handler.rxData(*p++);
+    } else {
+      while (p < end) {
+        size_t len = (size_t)(end - p) < chunk ? (size_t)(end - p) : chunk;
+        handler.rxData(p, len);
+        p += len;
+      }
+    }
+    bytes += data.size();
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  } while (elapsed * 1000 < minMs);
+
+  Result result;
+  result.nsPerByte = elapsed * 1e9 / bytes;
+  result.frames = handler.getStats().textFrames;
+  result.framesPerSecond = result.frames / elapsed;
+  result.allocations = allocations - before;
+  return result;
+}
+
+int main(int argc, char** argv) {
+  int minMs = 200;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--ms") == 0 && i + 1 < argc) minMs = atoi(argv[++i]);
+    else if (strcmp(argv[i], "--help") == 0) {
+      printf("usage: %s [--ms <min run time per case>] [capture ...]\n", argv[0]);
+      return 0;
+    }
+    else files.push_back(argv[i]);
+  }
+  if (files.empty()) {
+    for (const char* name : defaultCaptures) files.push_back(std::string(VEDIRECT_CAPTURES) + "/" + name);
+  }
+
+  static const size_t chunks[] = { 0, 16, 256 };
+  printf("%-14s %-8s %-6s %9s %12s %8s %7s\n", "capture", "stream", "rxData", "ns/byte", "frames/s", "frames", "allocs");
+  for (const std::string& file : files) {
+    std::vector<uint8_t> clean;
+    if (!readCapture(file, clean)) {
+      fprintf(stderr, "can't read %s\n", file.c_str());
+      return 1;
+    }
+    const std::vector<uint8_t> streams[] = { clean, corrupt(clean, 0.01) };
+    const char* streamNames[] = { "clean", "noisy" };
+    std::string name = file.substr(file.find_last_of('/') + 1);
+    for (int s = 0; s < 2; s++) {
+      for (size_t chunk : chunks) {
+        Result r = run(streams[s], chunk, minMs);
+        std::string mode = chunk ? std::to_string(chunk) : "byte";
+        printf("%-14s %-8s %-6s %9.2f %12.0f %8u %7zu\n", name.c_str(), streamNames[s], mode.c_str(),
+               r.nsPerByte, r.framesPerSecond, r.frames, r.allocations);
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,182 @@
+/* vedirect_fuzz.cpp
+ *
+ * Differential fuzz target: the byte-wise and the bulk rxData must produce identical frames,
+ * HEX messages and counters for any input.
+ *
+ * Built as a libFuzzer target with clang. With other compilers a small driver replays the
+ * corpus and random mutations of it:
+ *   vedirect_fuzz [-runs=N] [-seed=S] <file or directory> ...
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ * 2026.10.14 - 0.2 - run every input with and without resync
+ * 2026.10.14 - 0.3 - partial acceptance, typed values must match the stored strings
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "VeDirectFrameHandler.h"
+
+#define FUZZ_CHECK(cond) do { if (!(cond)) { fprintf(stderr, "check failed: %s (line %d)\n", #cond, __LINE__); abort(); } } while (0)
+
+/**
+ * @brief Pair of handlers, one fed byte-wise, one with buffers
+ */
+template <typename Handler>
+struct FuzzPair {
+  Handler bytewise;
+  Handler bulk;
+  std::string hexBytewise;
+  std::string hexBulk;
+  uint32_t framesBytewise = 0;
+  uint32_t framesBulk = 0;
+
+  static void onHex(const VeHexMessage& message, void* log) {
+    std::string& s = *static_cast<std::string*>(log);
+    char line[32];
+    snprintf(line, sizeof(line), "%X %04X %X %d:", message.response, message.reg, message.flags, message.len);
+    s += line;
+    s.append((const char*)message.data, message.len);
+  }
+  static void onFrame(VeDirectFrameHandlerBase&, void* frames) {
+    ++*static_cast<uint32_t*>(frames);
+  }
+
+  FuzzPair(bool resync, bool partial) {
+    bytewise.resync = resync;
+    bulk.resync = resync;
+    bytewise.partialAccept = partial;
+    bulk.partialAccept = partial;
+    bytewise.addHexMessageCallback(VE_HEX_ANY, VE_HEX_ANY_REGISTER, onHex, &hexBytewise);
+    bulk.addHexMessageCallback(VE_HEX_ANY, VE_HEX_ANY_REGISTER, onHex, &hexBulk);
+    bytewise.addFrameCallback(onFrame, &framesBytewise);
+    bulk.addFrameCallback(onFrame, &framesBulk);
+  }
+
+  void check() {
+    FUZZ_CHECK(bytewise.veEnd == bulk.veEnd);
+    FUZZ_CHECK(bytewise.veEnd >= 0 && bytewise.veEnd <= Handler::maxLabels);
+    for (int i = 0; i < bytewise.veEnd; i++) {
+      FUZZ_CHECK(strnlen(bytewise.veData[i].veName, nameLen) < nameLen);
+      FUZZ_CHECK(strnlen(bytewise.veData[i].veValue, valueLen) < valueLen);
+      FUZZ_CHECK(strcmp(bytewise.veData[i].veName, bulk.veData[i].veName) == 0);
+      FUZZ_CHECK(strcmp(bytewise.veData[i].veValue, bulk.veData[i].veValue) == 0);
+    }
+    FUZZ_CHECK(bytewise.getFrameCount() == bulk.getFrameCount());
+    FUZZ_CHECK(framesBytewise == framesBulk);
+    FUZZ_CHECK(bytewise.isDataAvailable() == bulk.isDataAvailable());
+    FUZZ_CHECK(memcmp(&bytewise.getStats(), &bulk.getStats(), sizeof(VeDirectFrameHandlerBase::VeStats)) == 0);
+    FUZZ_CHECK(hexBytewise == hexBulk);
+    for (int i = 0; i < bytewise.veEnd; i++) FUZZ_CHECK(bytewise.isVerified(i) == bulk.isVerified(i));
+    for (int i = 0; i < VE_LABEL_COUNT; i++) {
+      int32_t a = 0, b = 0, parsed = 0;
+      bool typed = bytewise.getTyped((VeLabel)i, a);
+      FUZZ_CHECK(typed == bulk.getTyped((VeLabel)i, b));
+      FUZZ_CHECK(a == b);
+      // the typed store always matches the strings of the committed frame
+      const char* value = bytewise.getValue(veLabels[i].name);
+      FUZZ_CHECK(typed == (value && veParseValue(veLabels[i].type, value, parsed)));
+      FUZZ_CHECK(!typed || a == parsed);
+    }
+  }
+
+  /**
+   * @brief Feed data to both handlers, the bulk one in chunks of pseudo random length
+   */
+  void run(const uint8_t* data, size_t size, uint32_t seed) {
+    size_t pos = 0;
+    while (pos < size) {
+      seed = seed * 1103515245u + 12345u;
+      size_t len = 1 + (seed >> 16) % ((seed & 0x100) ? 8 : 200);
+      if (len > size - pos) len = size - pos;
+      for (size_t i = 0; i < len; i++) bytewise.rxData(data[pos + i]);
+      bulk.rxData(data + pos, len);
+      pos += len;
+      check();
+    }
+  }
+};
+
+struct DefaultHandler : VeDirectFrameHandler { static const int maxLabels = buffLen; };
+struct SmallHandler : VeDirectFrameHandlerT<8, 6, 24> { static const int maxLabels = 8; };
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  uint32_t seed = size > 0 ? data[0] : 0;
+  FuzzPair<DefaultHandler>(false, false).run(data, size, seed);
+  FuzzPair<SmallHandler>(false, false).run(data, size, seed ^ 0x5A5A);
+  FuzzPair<DefaultHandler>(true, false).run(data, size, seed ^ 0xA5A5);
+  FuzzPair<SmallHandler>(true, true).run(data, size, seed ^ 0xFFFF);
+  FuzzPair<DefaultHandler>(false, true).run(data, size, seed ^ 0x3C3C);
+  return 0;
+}
+
+#ifndef VEDIRECT_LIBFUZZER
+#include <dirent.h>
+#include <vector>
+
+static std::vector<std::vector<uint8_t>> corpus;
+
+static void load(const std::string& path) {
+  DIR* dir = opendir(path.c_str());
+  if (dir) {
+    while (struct dirent* entry = readdir(dir)) {
+      if (entry->d_name[0] != '.') load(path + "/" + entry->d_name);
+    }
+    closedir(dir);
+    return;
+  }
+  FILE* fp = fopen(path.c_str(), "rb");
+  if (!fp) {
+    fprintf(stderr, "can't read %s\n", path.c_str());
+    exit(1);
+  }
+  std::vector<uint8_t> data;
+  int c;
+  while ((c = fgetc(fp)) != EOF) data.push_back((uint8_t)c);
+  fclose(fp);
+  corpus.push_back(data);
+}
+
+int main(int argc, char** argv) {
+  long runs = 10000;
+  uint32_t seed = 1;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "-runs=", 6) == 0) runs = atol(argv[i] + 6);
+    else if (strncmp(argv[i], "-seed=", 6) == 0) seed = (uint32_t)atol(argv[i] + 6);
+    else load(argv[i]);
+  }
+  if (corpus.empty()) corpus.push_back(std::vector<uint8_t>());
+
+  for (const std::vector<uint8_t>& input : corpus) LLVMFuzzerTestOneInput(input.data(), input.size());
+
+  // mutate: flip, insert and drop bytes, splice two inputs, favour the protocol delimiters
+  static const uint8_t special[] = { '\r', '\n', '\t', ':', '0', 'A', 'F' };
+  for (long run = 0; run < runs; run++) {
+    seed = seed * 1103515245u + 12345u;
+    std::vector<uint8_t> input = corpus[(seed >> 8) % corpus.size()];
+    int mutations = 1 + (seed >> 24) % 16;
+    for (int m = 0; m < mutations; m++) {
+      seed = seed * 1103515245u + 12345u;
+      size_t pos = input.empty() ? 0 : (seed >> 8) % input.size();
+      uint8_t byte = (seed & 1) ? special[(seed >> 4) % sizeof(special)] : (uint8_t)(seed >> 16);
+      switch ((seed >> 1) % 4) {
+        case 0: if (!input.empty()) input[pos] = byte; break;
+        case 1: input.insert(input.begin() + pos, byte); break;
+        case 2: if (!input.empty()) input.erase(input.begin() + pos); break;
+        case 3: {
+          const std::vector<uint8_t>& other = corpus[(seed >> 12) % corpus.size()];
+          input.insert(input.begin() + pos, other.begin(), other.end());
+          break;
+        }
+      }
+    }
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+  }
+  printf("%zu inputs and %ld mutations ok\n", corpus.size(), runs);
+  return 0;
+}
+#endif
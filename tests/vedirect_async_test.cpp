@@ -0,0 +1,90 @@
+/* vedirect_async_test.cpp
+ *
+ * Checks the HEX queries of VeDirectAsync: answered, timed out, and failed at once without a
+ * clock. Needs C++20.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ */
+
+#include <cstdio>
+
+#include "VeDirectAsync.h"
+
+static int failures = 0;
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+      failures++; \
+    } \
+  } while (0)
+
+static uint32_t now = 0;
+static uint32_t testClock() { return now; }
+
+static int writes = 0;
+static int testWrite(const char*, int len, void*) {
+  writes++;
+  return len;
+}
+
+struct Query {
+  bool done = false;                        // the coroutine was resumed
+  bool ok = false;                          // result of the query
+  VeHexMessage message = { };
+};
+
+static VeDirectTask runQuery(VeDirectAsync& async, uint16_t reg, uint32_t timeout, Query& query) {
+  query.ok = co_await async.query(reg, query.message, timeout);
+  query.done = true;
+}
+
+// GET response of the panel voltage (0xEDBB) with 12.34 V
+static void respond(VeDirectFrameHandlerBase& handler) {
+  const uint8_t payload[] = { 0xBB, 0xED, 0x00, 0xD2, 0x04 };
+  char frame[32];
+  int len = veHexEncode(frame, sizeof(frame), VE_HEX_GET, payload, sizeof(payload));
+  CHECK(len > 0);
+  handler.rxData((const uint8_t*)frame, len);
+}
+
+int main() {
+  {                                         // answered
+    VeDirectFrameHandler handler;
+    VeDirectAsync async(handler, testWrite, nullptr, testClock);
+    CHECK(async.attached());
+    Query query;
+    writes = 0;
+    runQuery(async, 0xEDBB, 100, query);
+    CHECK(!query.done && writes == 1);
+    respond(handler);
+    CHECK(query.done && query.ok && query.message.value == 1234);
+  }
+  {                                         // timed out
+    VeDirectFrameHandler handler;
+    VeDirectAsync async(handler, testWrite, nullptr, testClock);
+    Query query;
+    now = 0;
+    runQuery(async, 0xEDBB, 100, query);
+    now = 99;
+    CHECK(async.expire() == 0 && !query.done);
+    now = 100;
+    CHECK(async.expire() == 1 && query.done && !query.ok);
+  }
+  {                                         // no clock: fails at once, nothing is sent
+    VeDirectFrameHandler handler;
+    VeDirectAsync async(handler, testWrite, nullptr);
+    CHECK(async.attached());
+    Query query;
+    writes = 0;
+    runQuery(async, 0xEDBB, 100, query);
+    CHECK(query.done && !query.ok && writes == 0);
+    respond(handler);
+    CHECK(!query.ok);
+  }
+
+  if (failures) fprintf(stderr, "%d checks failed\n", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,108 @@
+/* vedirect_linux_serial_test.cpp
+ *
+ * Feeds a capture through a pty in chunks of exactly VEDIRECT_LINUX_CHUNK bytes and checks that
+ * VeDirectLinuxSerial receives all of it and reports the hangup of the pty.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "VeDirectFrameHandler.h"
+#include "VeDirectLinuxSerial.h"
+
+static int failures = 0;
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+      failures++; \
+    } \
+  } while (0)
+
+static void hangup(int port, void* data) {
+  *static_cast<int*>(data) = port;
+}
+
+static bool readFile(const char* path, std::vector<uint8_t>& data) {
+  FILE* file = fopen(path, "rb");
+  if (!file) return false;
+  uint8_t buffer[4096];
+  size_t len;
+  while ((len = fread(buffer, 1, sizeof(buffer), file)) > 0) data.insert(data.end(), buffer, buffer + len);
+  fclose(file);
+  return true;
+}
+
+int main() {
+  std::vector<uint8_t> capture;
+  if (!readFile(VEDIRECT_CAPTURES "/mppt.vd", capture)) {
+    perror(VEDIRECT_CAPTURES "/mppt.vd");
+    return 1;
+  }
+  capture.resize(capture.size() / VEDIRECT_LINUX_CHUNK * VEDIRECT_LINUX_CHUNK);
+
+  // reference: the same bytes parsed directly
+  VeDirectFrameHandler expected;
+  expected.rxData(capture.data(), capture.size());
+
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if (master < 0 || grantpt(master) < 0 || unlockpt(master) < 0) {
+    perror("posix_openpt");
+    return 1;
+  }
+  VeDirectFrameHandler handler;
+  VeDirectLinuxSerial serial;
+  int port = serial.open(ptsname(master), handler);
+  if (port < 0) {
+    perror("open");
+    return 1;
+  }
+  int hungUp = -1;
+  serial.setHangupCallback(hangup, &hungUp);
+
+  // every chunk is completely in the pty before it is read, so the read fills the whole buffer
+  size_t received = 0;
+  for (size_t pos = 0; pos < capture.size(); pos += VEDIRECT_LINUX_CHUNK) {
+    CHECK(write(master, capture.data() + pos, VEDIRECT_LINUX_CHUNK) == VEDIRECT_LINUX_CHUNK);
+    usleep(10000);
+    for (int tries = 0; received < pos + VEDIRECT_LINUX_CHUNK && tries < 10; tries++) {
+      int len = serial.poll(100);
+      CHECK(len >= 0);
+      if (len > 0) received += len;
+    }
+    CHECK(serial.isOpen(port));
+    if (received < pos + VEDIRECT_LINUX_CHUNK) break;      // lost, the following chunks would be too
+  }
+  CHECK(received == capture.size());
+  CHECK(serial.poll(0) == 0);               // no data left, the empty tty stays in the wait
+  CHECK(serial.isOpen(port));
+  CHECK(hungUp == -1);
+  CHECK(handler.getStats().bytes == expected.getStats().bytes);
+  CHECK(handler.getStats().textFrames == expected.getStats().textFrames);
+  CHECK(handler.getStats().textFrames > 0);
+  CHECK(handler.getSnapshot().frame == expected.getSnapshot().frame);
+
+  // closing the master side hangs up the tty
+  close(master);
+  for (int tries = 0; hungUp < 0 && tries < 10; tries++) CHECK(serial.poll(100) >= 0);
+  CHECK(hungUp == port);
+  CHECK(!serial.isOpen(port));
+  CHECK(serial.poll(0) == 0);
+
+  serial.close();
+  if (failures) {
+    fprintf(stderr, "%d checks failed\n", failures);
+    return 1;
+  }
+  printf("ok: %zu bytes, %u frames\n", received, handler.getStats().textFrames);
+  return 0;
+}
@@ -0,0 +1,70 @@
+/* vedirect_size_test.cpp
+ *
+ * Checks that a compact handler is smaller than the handler of release 0.5 and still works
+ * with the default callback capacities.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include "VeDirectFrameHandler.h"
+
+// sizeof(VeDirectFrameHandler) of release 0.5 on a 64 bit host: 40 labels plus a frame buffer
+static const size_t baselineSize = 2816;
+
+typedef VeDirectFrameHandlerT<20, 20, 80> CompactHandler;
+
+// the log callback and the metrics add their state to every handler
+#if !defined(VEDIRECT_LOG) && !defined(VEDIRECT_METRICS)
+static_assert(sizeof(void*) != 8 || sizeof(CompactHandler) < baselineSize,
+              "a compact handler must be smaller than the handler of release 0.5");
+#endif
+
+static int failures = 0;
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+      failures++; \
+    } \
+  } while (0)
+
+static void onFrame(VeDirectFrameHandlerBase&, void* data) {
+  ++*static_cast<int*>(data);
+}
+
+static size_t appendFrame(uint8_t* buffer, const char* records) {
+  size_t len = strlen(records);
+  memcpy(buffer, records, len);
+  uint8_t sum = 0;
+  for (size_t i = 0; i < len; i++) sum += buffer[i];
+  buffer[len] = (uint8_t)(256 - sum);
+  return len + 1;
+}
+
+int main() {
+  printf("sizeof VeDirectFrameHandler %zu, VeDirectFrameHandlerT<20, 20, 80> %zu, baseline %zu\n",
+         sizeof(VeDirectFrameHandler), sizeof(CompactHandler), baselineSize);
+
+  static CompactHandler handler;
+  int frames = 0;
+  CHECK(handler.addFrameCallback(onFrame, &frames) > 0);
+  CHECK(handler.addFrameCallback(onFrame, &frames) > 0);
+  CHECK(handler.addFrameCallback(onFrame, &frames) < 0);   // VEDIRECT_MAX_FRAME_CALLBACKS
+
+  uint8_t buffer[128];
+  size_t len = appendFrame(buffer, "\r\nPID\t0xA053\r\nV\t12800\r\nI\t-1500\r\nChecksum\t");
+  handler.rxData(buffer, len);
+  CHECK(frames == 2);
+  int32_t value = 0;
+  CHECK(handler.getTyped(VE_LABEL_V, value) && value == 12800);
+  CHECK(handler.getTyped(VE_LABEL_I, value) && value == -1500);
+  CHECK(handler.getValue("PID") && strcmp(handler.getValue("PID"), "0xA053") == 0);
+
+  if (failures) fprintf(stderr, "%d checks failed\n", failures);
+  return failures ? 1 : 0;
+}
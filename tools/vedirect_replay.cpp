@@ -0,0 +1,291 @@
+/* vedirect_replay.cpp
+ *
+ * Replays an archived VE.Direct capture on all cores and writes one CSV row per valid frame.
+ *
+ * The MIT License, see LICENSE
+ *
+ * 2026.10.14 - 0.1 - initial release
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "VeDirectFrameHandler.h"
+
+// end of every TEXT frame, followed by the checksum byte and the next frame
+static const char frameEnd[] = "\r\nChecksum\t";
+static const size_t frameEndLen = sizeof(frameEnd) - 1;
+
+struct Options {
+  unsigned jobs = std::max(1u, std::thread::hardware_concurrency());
+  size_t chunk = 4 << 20;                   // bytes per work item
+  size_t warmup = 4096;                     // bytes parsed before a chunk to restore the store of the frames before
+  bool resync = false;
+  bool partial = false;
+  std::vector<uint8_t> labels;              // columns, empty to take the labels of the start of the capture
+};
+
+struct Result {                             // output of one chunk
+  std::string csv;
+  VeDirectFrameHandlerBase::VeStats stats;  // counted within the chunk only
+  bool done = false;
+};
+
+/**
+ * @brief Offset of the first frame boundary (the byte after a checksum byte) at or after pos
+ *
+ * @return size_t   Boundary, or size if there is none
+ */
+static size_t nextBoundary(const uint8_t* data, size_t size, size_t pos) {
+  if (pos == 0) return 0;
+  if (pos >= size) return size;
+  const void* hit = memmem(data + pos, size - pos, frameEnd, frameEndLen);
+  if (!hit) return size;
+  return std::min(size, (size_t)((const uint8_t*)hit - data) + frameEndLen + 1);
+}
+
+static void appendInt(std::string& out, int32_t value) {
+  char buffer[12];
+  int pos = sizeof(buffer);
+  uint32_t rest = value < 0 ? -(uint32_t)value : value;
+  do {
+    buffer[--pos] = '0' + rest % 10;
+    rest /= 10;
+  } while (rest);
+  if (value < 0) buffer[--pos] = '-';
+  out.append(buffer + pos, sizeof(buffer) - pos);
+}
+
+static void appendText(std::string& out, const char* text) {
+  if (!strpbrk(text, ",\"\r\n")) {
+    out.append(text);
+    return;
+  }
+  out.push_back('"');
+  for (const char* c = text; *c; c++) {
+    if (*c == '"') out.push_back('"');
+    out.push_back(*c);
+  }
+  out.push_back('"');
+}
+
+/**
+ * @brief Append the row of the last committed frame: its end offset and the selected labels
+ * @details Typed values are written as numbers (ON/OFF as 1/0, hex as decimal), the others as text.
+ */
+static void appendRow(std::string& out, size_t offset, const VeDirectFrameHandlerBase::VeStore& store,
+                      const std::vector<uint8_t>& labels) {
+  out.append(std::to_string(offset));
+  for (uint8_t label : labels) {
+    out.push_back(',');
+    int slot = store.slotOf(label);
+    if (slot < 0) continue;
+    if (store.isTyped(slot)) appendInt(out, store.typedValue[slot]);
+    else appendText(out, store.data[slot].veValue);
+  }
+  out.push_back('\n');
+}
+
+/**
+ * @brief Parse data[from, to) frame by frame, with rows for the frames ending after start
+ */
+static void parse(VeDirectFrameHandlerBase& handler, const uint8_t* data, size_t from, size_t start, size_t to,
+                  const std::vector<uint8_t>& labels, Result& result) {
+  uint32_t frame = handler.getSnapshot().frame;
+  VeDirectFrameHandlerBase::VeStats before = handler.getStats();
+  for (size_t pos = from; pos < to; ) {
+    if (pos == start) before = handler.getStats();
+    size_t next = nextBoundary(data, to, pos + 1);
+    if (pos < start) next = std::min(next, start);
+    handler.rxData(data + pos, next - pos);
+    pos = next;
+    if (handler.getSnapshot().frame == frame) continue;
+    frame = handler.getSnapshot().frame;
+    if (pos > start) appendRow(result.csv, pos, handler.getSnapshot(), labels);
+  }
+  const VeDirectFrameHandlerBase::VeStats& after = handler.getStats();
+  result.stats.bytes = after.bytes - before.bytes;
+  result.stats.textFrames = after.textFrames - before.textFrames;
+  result.stats.textChecksumErrors = after.textChecksumErrors - before.textChecksumErrors;
+  result.stats.partialFrames = after.partialFrames - before.partialFrames;
+}
+
+/**
+ * @brief Labels received at the start of the capture, in the order of VeLabel
+ */
+static std::vector<uint8_t> detectLabels(const uint8_t* data, size_t size, const Options& options) {
+  VeDirectFrameHandler handler;
+  handler.resync = options.resync;
+  handler.partialAccept = options.partial;
+  handler.rxData(data, nextBoundary(data, size, std::min(size, (size_t)1 << 20)));
+  std::vector<uint8_t> labels;
+  for (uint8_t label = 0; label < VE_LABEL_COUNT; label++) {
+    if (handler.getSnapshot().slotOf(label) >= 0) labels.push_back(label);
+  }
+  return labels;
+}
+
+/**
+ * @brief Parse the label names of --labels, e.g. "V,I,SER#"
+ */
+static bool parseLabels(const char* list, std::vector<uint8_t>& labels) {
+  std::string names(list);
+  for (size_t pos = 0; pos <= names.size(); ) {
+    size_t end = std::min(names.find(',', pos), names.size());
+    std::string name = names.substr(pos, end - pos);
+    for (char& c : name) c = toupper((unsigned char)c);
+    VeLabel label = veLabelFromName(name.c_str());
+    if (label == VE_LABEL_UNKNOWN || label == VE_LABEL_CHECKSUM) {
+      fprintf(stderr, "unknown label %s\n", name.c_str());
+      return false;
+    }
+    labels.push_back(label);
+    pos = end + 1;
+  }
+  return true;
+}
+
+static int usage(const char* name) {
+  printf("usage: %s [--jobs <threads>] [--chunk <KiB>] [--warmup <bytes>] [--labels V,I,...]\n"
+         "       [--resync] [--partial] [--output <file.csv>] <capture>\n", name);
+  return 1;
+}
+
+int main(int argc, char** argv) {
+  Options options;
+  const char* input = nullptr;
+  const char* output = nullptr;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) options.jobs = std::max(1, atoi(argv[++i]));
+    else if (strcmp(argv[i], "--chunk") == 0 && i + 1 < argc) options.chunk = std::max(1L, atol(argv[++i])) << 10;
+    else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) options.warmup = atol(argv[++i]);
+    else if (strcmp(argv[i], "--labels") == 0 && i + 1 < argc) {
+      if (!parseLabels(argv[++i], options.labels)) return 1;
+    }
+    else if (strcmp(argv[i], "--resync") == 0) options.resync = true;
+    else if (strcmp(argv[i], "--partial") == 0) options.partial = true;
+    else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) output = argv[++i];
+    else if (argv[i][0] == '-' || input) return usage(argv[0]);
+    else input = argv[i];
+  }
+  if (!input) return usage(argv[0]);
+
+  // map the capture, the workers read it in place
+  int fd = open(input, O_RDONLY | O_CLOEXEC);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) < 0 || st.st_size == 0) {
+    fprintf(stderr, "can't read %s\n", input);
+    return 1;
+  }
+  size_t size = st.st_size;
+  void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    perror("mmap");
+    return 1;
+  }
+  madvise(map, size, MADV_SEQUENTIAL);
+  const uint8_t* data = static_cast<const uint8_t*>(map);
+
+  FILE* out = output ? fopen(output, "w") : stdout;
+  if (!out) {
+    perror(output);
+    return 1;
+  }
+  static char outBuffer[1 << 20];
+  setvbuf(out, outBuffer, _IOFBF, sizeof(outBuffer));
+
+  std::vector<uint8_t> labels = options.labels.empty() ? detectLabels(data, size, options) : options.labels;
+  fputs("offset", out);
+  for (uint8_t label : labels) fprintf(out, ",%s", veLabels[label].name);
+  fputc('\n', out);
+
+  std::vector<size_t> bounds;               // chunk i is bounds[i]..bounds[i + 1]
+  for (size_t pos = 0; pos < size; pos += options.chunk) {
+    size_t bound = nextBoundary(data, size, pos);
+    if (bounds.empty() || bound > bounds.back()) bounds.push_back(bound);
+  }
+  if (bounds.back() < size) bounds.push_back(size);
+  size_t chunks = bounds.size() - 1;
+
+  // the workers take the chunks in order, at most window chunks ahead of the writer
+  std::vector<Result> results(chunks);
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::atomic<size_t> nextChunk{0};
+  size_t written = 0;
+  size_t window = 4 * options.jobs;
+
+  auto worker = [&]() {
+    for (size_t i; (i = nextChunk++) < chunks; ) {
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return i < written + window; });
+      }
+      size_t start = bounds[i];
+      size_t from = start > options.warmup ? nextBoundary(data, start, start - options.warmup) : 0;
+      VeDirectFrameHandler handler;
+      handler.resync = options.resync;
+      handler.partialAccept = options.partial;
+      Result result;
+      parse(handler, data, from, start, bounds[i + 1], labels, result);
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        results[i].csv.swap(result.csv);
+        results[i].stats = result.stats;
+        results[i].done = true;
+      }
+      changed.notify_all();
+    }
+  };
+
+  auto begin = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < std::min<size_t>(options.jobs, chunks); i++) threads.emplace_back(worker);
+
+  VeDirectFrameHandlerBase::VeStats total = { };
+  for (size_t i = 0; i < chunks; i++) {
+    std::string csv;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      changed.wait(lock, [&] { return results[i].done; });
+      csv.swap(results[i].csv);
+      total.bytes += results[i].stats.bytes;
+      total.textFrames += results[i].stats.textFrames;
+      total.textChecksumErrors += results[i].stats.textChecksumErrors;
+      total.partialFrames += results[i].stats.partialFrames;
+      written = i + 1;
+    }
+    changed.notify_all();
+    fwrite(csv.data(), 1, csv.size(), out);
+  }
+  for (std::thread& thread : threads) thread.join();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+  bool failed = ferror(out) != 0;
+  if (out != stdout) failed |= fclose(out) != 0;
+  else failed |= fflush(out) != 0;
+  munmap(map, size);
+  fprintf(stderr, "%zu bytes, %zu chunks, %u jobs: %u frames, %u partial, %u checksum errors, %.3fs, %.1f MB/s\n",
+          size, chunks, options.jobs, total.textFrames, total.partialFrames, total.textChecksumErrors,
+          seconds, seconds > 0 ? size / seconds / 1e6 : 0.0);
+  if (failed) {
+    perror("write");
+    return 1;
+  }
+  return 0;
+}